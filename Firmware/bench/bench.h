@@ -0,0 +1,43 @@
+/**
+ * @file   bench.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  On-target micro-benchmark suite (make bench).
+ */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include <stdint.h>
+#include "harness.h"
+
+/* No clock tree setup yet, the core runs from the 8 MHz HSI after reset. */
+#ifndef CORE_CLOCK_HZ
+#define CORE_CLOCK_HZ   8000000
+#endif
+
+#ifndef BUILD_PROFILE
+#define BUILD_PROFILE   "unknown"
+#endif
+
+/* Keep the compiler from optimising away writes only the bus can see. */
+#define bench_clobber() __asm__ volatile ("" : : : "memory")
+
+const char *bench_name(const char *prefix, uint32_t n, const char *suffix);
+
+void bench_mem(void);
+void bench_crc(void);
+void bench_irq(void);
+void bench_ctxsw(void);
+void bench_gpio(void);
+void bench_exec(void);
+void bench_dsp(void);
+void bench_swtimer(void);
+void bench_log(void);
+void bench_prof(void);
+void bench_reg(void);
+void bench_defer(void);
+void bench_link(void);
+void bench_cpuacct(void);
+
+#endif /* __BENCH_H */
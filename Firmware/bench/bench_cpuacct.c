@@ -0,0 +1,44 @@
+/**
+ * @file   bench_cpuacct.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  CPU accounting costs: what an instrumented handler or stage
+ *         pays per run, and a report.
+ */
+
+#include "cpuacct.h"
+#include "bench.h"
+
+#define ITERATIONS  1000
+
+static cpuacct_ctx_t stage, irq;
+
+void bench_cpuacct(void)
+{
+    cpuacct_report_t r;
+
+    cpuacct_init();
+    cpuacct_setup(&stage, "stage", CPUACCT_STAGE);
+    cpuacct_setup(&irq, "irq", CPUACCT_IRQ);
+
+    BENCH("cpuacct_enter_exit", ITERATIONS, cpuacct_enter(&stage); cpuacct_exit(&stage));
+    BENCH("cpuacct_nested", ITERATIONS,
+          cpuacct_enter(&stage); cpuacct_enter(&irq); cpuacct_exit(&irq); cpuacct_exit(&stage));
+    BENCH("cpuacct_report", ITERATIONS, cpuacct_report(&r));
+
+    // how the counters split one instrumented stage
+    cpuacct_report(&r);
+    for (volatile int i = 0; i < ITERATIONS; ++i) {
+        cpuacct_enter(&stage);
+        bench_clobber();
+        cpuacct_exit(&stage);
+    }
+    cpuacct_report(&r);
+    harness_conf_u32("cpuacct_window", r.window);
+    harness_conf_u32("cpuacct_stage_cycles", stage.last.cycles);
+    harness_conf_u32("cpuacct_stage_counted", stage.last.counted);
+    harness_conf_u32("cpuacct_stage_instructions", cpuacct_instructions(&stage.last));
+    harness_conf_u32("cpuacct_stall", r.stall);
+    harness_conf_u32("cpuacct_exc", r.exc);
+    harness_conf_u32("cpuacct_load_pm", r.load_pm);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file   bench_crc.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  CRC-32 software vs. hardware benchmarks.
+ */
+
+#include "crc.h"
+#include "bench.h"
+
+#define CRC_WORDS   256
+#define ITERATIONS  10
+
+static uint32_t crc_buf[CRC_WORDS];
+
+void bench_crc(void)
+{
+    volatile uint32_t result;
+
+    for (uint32_t i = 0; i < CRC_WORDS; ++i)
+        crc_buf[i] = i * 0x9E3779B9;
+
+    crc_init();
+    harness_conf("crc32_hw_matches_sw",
+                 crc32_hw(crc_buf, CRC_WORDS) == crc32_sw(crc_buf, CRC_WORDS)
+                 ? "yes" : "no");
+
+    BENCH("crc32_sw_bitwise_1k", ITERATIONS,
+          result = crc32_sw_bitwise(crc_buf, CRC_WORDS));
+    BENCH("crc32_sw_table_1k", ITERATIONS,
+          result = crc32_sw(crc_buf, CRC_WORDS));
+#ifndef BOARD_QEMU
+    BENCH("crc32_hw_1k", ITERATIONS,
+          result = crc32_hw(crc_buf, CRC_WORDS));
+#endif
+    (void) result;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file   bench_ctxsw.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  PendSV context switch benchmark.
+ *
+ * Two tasks on their own process stacks ping-pong through PendSV, the
+ * usual RTOS switch: hardware stacks r0-r3, r12, lr, pc, xpsr and the
+ * handler saves r4-r11. SVC enters the tasks from main() and returns.
+ */
+
+#include "core_cm3.h"
+#include "bench.h"
+
+#define ROUNDS          1000
+#define STACK_WORDS     128
+
+// SCB_ICSR
+#define ICSR_PENDSVSET  (1 << 28)
+
+// xPSR
+#define XPSR_T          (1 << 24)
+
+static uint32_t task_stack[2][STACK_WORDS] __attribute__((aligned(8)));
+static volatile uint32_t ctxsw_cycles;
+
+/* Used from the naked handlers below, keep the symbols as they are. */
+uint32_t *ctxsw_sp[2] __attribute__((used));
+uint32_t  ctxsw_cur __attribute__((used));
+
+static void pend_pendsv(void)
+{
+    SCB_ICSR = ICSR_PENDSVSET;
+    __asm__ volatile ("dsb\n\tisb" : : : "memory");
+}
+
+static void task_ping(void)
+{
+    uint32_t start = harness_cycles();
+    for (int i = 0; i < ROUNDS; ++i)
+        pend_pendsv();
+    ctxsw_cycles = harness_cycles() - start;
+
+    __asm__ volatile ("svc 0" : : : "memory");
+    while (1) ;
+}
+
+static void task_pong(void)
+{
+    while (1)
+        pend_pendsv();
+}
+
+/**
+ * @brief Build the initial frame: r4-r11, then the hardware frame.
+ */
+static uint32_t *task_stack_init(uint32_t *top, void (*entry)(void))
+{
+    uint32_t *sp = top - 16;
+
+    for (int i = 0; i < 16; ++i)
+        sp[i] = 0;
+    sp[8 + 6] = (uint32_t) entry & ~1u;     // pc
+    sp[8 + 7] = XPSR_T;                     // xpsr
+    return sp;
+}
+
+/**
+ * @brief Save r4-r11 of the current task, switch to the other one.
+ */
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm__ volatile (
+        "mrs    r0, psp                 \n"
+        "stmdb  r0!, {r4-r11}           \n"
+        "ldr    r1, =ctxsw_cur          \n"
+        "ldr    r2, [r1]                \n"
+        "ldr    r3, =ctxsw_sp           \n"
+        "str    r0, [r3, r2, lsl #2]    \n"
+        "eor    r2, r2, #1              \n"
+        "str    r2, [r1]                \n"
+        "ldr    r0, [r3, r2, lsl #2]    \n"
+        "ldmia  r0!, {r4-r11}           \n"
+        "msr    psp, r0                 \n"
+        "bx     lr                      \n"
+    );
+}
+
+/**
+ * @brief From main() (MSP): park main's r4-r11 on MSP, start task 0.
+ *        From a task (PSP): restore main's r4-r11, return to main().
+ */
+__attribute__((naked)) void SVCall_Handler(void)
+{
+    __asm__ volatile (
+        "tst    lr, #4                  \n"
+        "bne    1f                      \n"
+        "push   {r4-r11}                \n"
+        "ldr    r0, =ctxsw_sp           \n"
+        "ldr    r0, [r0]                \n"
+        "ldmia  r0!, {r4-r11}           \n"
+        "msr    psp, r0                 \n"
+        "mvn    lr, #2                  \n"     // EXC_RETURN 0xFFFFFFFD
+        "bx     lr                      \n"
+        "1:                             \n"
+        "pop    {r4-r11}                \n"
+        "mvn    lr, #6                  \n"     // EXC_RETURN 0xFFFFFFF9
+        "bx     lr                      \n"
+    );
+}
+
+void bench_ctxsw(void)
+{
+    ctxsw_sp[0] = task_stack_init(&task_stack[0][STACK_WORDS], task_ping);
+    ctxsw_sp[1] = task_stack_init(&task_stack[1][STACK_WORDS], task_pong);
+    ctxsw_cur = 0;
+
+    __asm__ volatile ("svc 0" : : : "memory");
+
+    harness_bench("context_switch", 2 * ROUNDS, ctxsw_cycles);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file   bench_defer.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Deferred work costs: what an interrupt handler pays to post,
+ *         and the dispatch overhead per item.
+ */
+
+#include "defer.h"
+#include "bench.h"
+
+#define ITERATIONS  1000
+
+static defer_work_t work;
+static volatile uint32_t runs;
+
+static void count_fn(void *arg)
+{
+    (void) arg;
+    runs++;
+}
+
+void bench_defer(void)
+{
+    // PendSV belongs to bench_ctxsw.c here, dispatch by hand
+    defer_init(DEFER_MAIN_LOOP);
+    defer_setup(&work, count_fn, 0, 1);
+
+    BENCH("defer_post_run", ITERATIONS, defer_post(&work); defer_run());
+    defer_post(&work);
+    BENCH("defer_post_coalesced", ITERATIONS, defer_post(&work));
+    defer_run();
+    BENCH("defer_run_empty", ITERATIONS, defer_run());
+    harness_conf_u32("defer_latency_max", work.stats.latency_max);
+}
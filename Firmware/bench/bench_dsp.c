@@ -0,0 +1,90 @@
+/**
+ * @file   bench_dsp.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  DSP kernel benchmarks, reported in cycles per sample.
+ *
+ * Filters run on 64-sample blocks, the size of one half of an ADC
+ * double buffer.
+ */
+
+#include "dsp.h"
+#include "bench.h"
+
+#define BLOCK       64
+#define BLOCKS      16
+#define FIR_TAPS    32
+#define STAGES      4
+
+static q15_t x15[BLOCK], y15[BLOCK];
+static q31_t x31[BLOCK], y31[BLOCK];
+static q15_t fir15_coeffs[FIR_TAPS];
+static q15_t fir15_state[FIR_TAPS - 1 + BLOCK];
+static q31_t fir31_coeffs[FIR_TAPS];
+static q31_t fir31_state[FIR_TAPS - 1 + BLOCK];
+static q31_t biquad_coeffs[5 * STAGES];
+static q31_t biquad_state[4 * STAGES];
+static q15_t fft_buf[2 * DSP_FFT_MAX_N];
+static q15_t fft_mag[DSP_FFT_MAX_N];
+static uint16_t adc_half[BLOCK];
+
+/**
+ * @brief Time `blocks` calls of `body`, report per sample.
+ */
+#define BENCH_SAMPLES(name, samples, blocks, body)                  \
+    do {                                                            \
+        uint32_t _start = harness_cycles();                         \
+        for (uint32_t _i = 0; _i < (blocks); ++_i) {                \
+            body;                                                   \
+        }                                                           \
+        harness_bench((name), (samples) * (blocks),                 \
+                      harness_cycles() - _start);                   \
+    } while (0)
+
+void bench_dsp(void)
+{
+    dsp_fir_q15_t fir15;
+    dsp_fir_q31_t fir31;
+    dsp_biquad_q31_t biquad;
+    volatile q15_t rms;
+
+    for (int i = 0; i < BLOCK; ++i) {
+        adc_half[i] = (i * 977) & 0x0FFF;
+        x15[i] = (q15_t) (i * 1021);
+        x31[i] = (q31_t) (i * 0x00810204);
+    }
+    for (int i = 0; i < FIR_TAPS; ++i) {
+        fir15_coeffs[i] = 1024 - i * 16;
+        fir31_coeffs[i] = (1024 - i * 16) << 16;
+    }
+    for (int s = 0; s < STAGES; ++s) {
+        q31_t *c = &biquad_coeffs[5 * s];
+        c[0] = 0x08000000;
+        c[1] = 0x10000000;
+        c[2] = 0x08000000;
+        c[3] = 0x40000000;
+        c[4] = -0x20000000;
+    }
+    for (int i = 0; i < 2 * DSP_FFT_MAX_N; ++i)
+        fft_buf[i] = (q15_t) (i * 331);
+
+    dsp_fir_q15_init(&fir15, FIR_TAPS, fir15_coeffs, fir15_state);
+    dsp_fir_q31_init(&fir31, FIR_TAPS, fir31_coeffs, fir31_state);
+    dsp_biquad_q31_init(&biquad, STAGES, biquad_coeffs, biquad_state, 1);
+
+    BENCH_SAMPLES("dsp_adc_to_q15", BLOCK, BLOCKS,
+                  dsp_adc_to_q15(adc_half, x15, BLOCK));
+    BENCH_SAMPLES("dsp_fir_q15_32taps", BLOCK, BLOCKS,
+                  dsp_fir_q15(&fir15, x15, y15, BLOCK));
+    BENCH_SAMPLES("dsp_fir_q31_32taps", BLOCK, BLOCKS,
+                  dsp_fir_q31(&fir31, x31, y31, BLOCK));
+    BENCH_SAMPLES("dsp_biquad_q31_4stages", BLOCK, BLOCKS,
+                  dsp_biquad_q31(&biquad, x31, y31, BLOCK));
+    BENCH_SAMPLES("dsp_rms_q15", BLOCK, BLOCKS,
+                  rms = dsp_rms_q15(x15, BLOCK));
+    BENCH_SAMPLES(bench_name("dsp_cfft_q15_", DSP_FFT_MAX_N, ""), DSP_FFT_MAX_N, 4,
+                  dsp_cfft_q15(fft_buf, DSP_FFT_MAX_N));
+    BENCH_SAMPLES("dsp_cmplx_mag_q15", DSP_FFT_MAX_N, 4,
+                  dsp_cmplx_mag_q15(fft_buf, fft_mag, DSP_FFT_MAX_N));
+    (void) rms;
+}
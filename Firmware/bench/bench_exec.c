@@ -0,0 +1,69 @@
+/**
+ * @file   bench_exec.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Fixed-point kernels, executed from flash and from SRAM.
+ */
+
+#include "compiler.h"
+#include "bench.h"
+
+#define N           256
+#define ITERATIONS  10
+
+static int16_t q15_a[N];
+static int16_t q15_b[N];
+static int32_t q31_buf[N];
+
+#define Q15_DOT_BODY                                    \
+    int64_t acc = 0;                                    \
+    for (uint32_t i = 0; i < n; ++i)                    \
+        acc += (int32_t) a[i] * b[i];                   \
+    return acc >> 15;
+
+static __attribute__((noinline)) int32_t
+q15_dot_flash(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    Q15_DOT_BODY
+}
+
+static __RAMFUNC int32_t
+q15_dot_sram(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    Q15_DOT_BODY
+}
+
+/**
+ * @brief Q31 gain, saturating: y = sat(x * gain).
+ */
+static __attribute__((noinline)) void
+q31_scale(int32_t *buf, int32_t gain, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        int64_t y = ((int64_t) buf[i] * gain) >> 31;
+        if (y > INT32_MAX)
+            y = INT32_MAX;
+        else if (y < INT32_MIN)
+            y = INT32_MIN;
+        buf[i] = y;
+    }
+}
+
+void bench_exec(void)
+{
+    volatile int32_t result;
+
+    for (uint32_t i = 0; i < N; ++i) {
+        q15_a[i] = (int16_t) (i * 1021);
+        q15_b[i] = (int16_t) (i * 4093);
+        q31_buf[i] = (int32_t) (i * 0x00810204);
+    }
+
+    BENCH("q15_dot_256_flash", ITERATIONS,
+          result = q15_dot_flash(q15_a, q15_b, N));
+    BENCH("q15_dot_256_sram", ITERATIONS,
+          result = q15_dot_sram(q15_a, q15_b, N));
+    BENCH("q31_scale_256", ITERATIONS,
+          q31_scale(q31_buf, 0x40000000, N); bench_clobber());
+    (void) result;
+}
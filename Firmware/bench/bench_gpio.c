@@ -0,0 +1,24 @@
+/**
+ * @file   bench_gpio.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  GPIO toggle rate benchmark (PC13).
+ */
+
+#include "stm32f107xc.h"
+#include "gpio.h"
+#include "bench.h"
+
+#define ITERATIONS  1000
+
+void bench_gpio(void)
+{
+    gpio_init();
+
+    BENCH("gpio_toggle_driver", ITERATIONS, gpio_on(); gpio_off());
+    // the driver before gpio.cpp: a load and a store per call
+    BENCH("gpio_toggle_rmw", ITERATIONS,
+          PORTC->BRR |= (1 << 13); PORTC->BSRR |= (1 << 13));
+    BENCH("gpio_toggle_bsrr", ITERATIONS,
+          PORTC->BSRR = (1 << 13); PORTC->BSRR = (1 << (13 + 16)));
+}
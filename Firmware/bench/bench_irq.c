@@ -0,0 +1,47 @@
+/**
+ * @file   bench_irq.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Interrupt entry / exit latency benchmark.
+ *
+ * EXTI0 is pended from software through NVIC_ISPR, so no pin or
+ * peripheral is involved and the same code runs under QEMU.
+ */
+
+#include "core_cm3.h"
+#include "bench.h"
+
+#define BENCH_IRQn  6       /* EXTI0 */
+#define ITERATIONS  1000
+
+static volatile uint32_t irq_entry;
+static volatile uint32_t irq_leave;
+
+void EXTI0_Handler(void)
+{
+    irq_entry = harness_cycles();
+    irq_leave = harness_cycles();
+}
+
+void bench_irq(void)
+{
+    uint32_t entry = 0;
+    uint32_t exit = 0;
+
+    NVIC_ISER0 = (1 << BENCH_IRQn);
+
+    for (int i = 0; i < ITERATIONS; ++i) {
+        uint32_t start = harness_cycles();
+        NVIC_ISPR0 = (1 << BENCH_IRQn);
+        __asm__ volatile ("dsb\n\tisb" : : : "memory");
+        uint32_t end = harness_cycles();
+
+        entry += irq_entry - start;
+        exit  += end - irq_leave;
+    }
+
+    NVIC_ICER0 = (1 << BENCH_IRQn);
+
+    harness_bench("irq_entry", ITERATIONS, entry);
+    harness_bench("irq_exit", ITERATIONS, exit);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file   bench_link.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Packet link costs: COBS, a whole data frame, a telemetry record.
+ */
+
+#include <string.h>
+#include "link.h"
+#include "tlm.h"
+#include "bench.h"
+
+#define ITERATIONS  100
+
+typedef struct
+{
+    uint32_t tick;
+    int16_t  temp[4];
+    float    rpm;
+} sample_t;
+
+static const tlm_field_t sample_fields[] = {
+    TLM_FIELD(sample_t, tick,    TLM_U32),
+    TLM_FIELD(sample_t, temp[0], TLM_I16),
+    TLM_FIELD(sample_t, temp[1], TLM_I16),
+    TLM_FIELD(sample_t, temp[2], TLM_I16),
+    TLM_FIELD(sample_t, temp[3], TLM_I16),
+    TLM_FIELD(sample_t, rpm,     TLM_F32),
+};
+static const tlm_record_t sample_rec = TLM_RECORD(1, "sample", sample_fields);
+
+static link_t link;
+static uint8_t payload[LINK_MTU];
+static uint8_t wire[LINK_WIRE_MAX];
+static volatile uint32_t written;
+
+static void sink(void *ctx, const uint8_t *buf, uint32_t len)
+{
+    (void) ctx;
+    (void) buf;
+    written += len;
+}
+
+void bench_link(void)
+{
+    uint8_t rec[32];
+    sample_t s = { 1, { 2, 3, 4, 5 }, 6.0f };
+
+    for (uint32_t i = 0; i < sizeof(payload); ++i)
+        payload[i] = i * 7;                 // a zero every 256 / 7 bytes
+    link_init(&link, sink, 0, 0);
+
+    BENCH("link_cobs_128", ITERATIONS, cobs_encode(payload, sizeof(payload), wire));
+    // nothing acknowledges, pretend it was
+    BENCH("link_send_128", ITERATIONS,
+          link_send(&link, payload, sizeof(payload)); link.tx_base = link.tx_seq);
+    BENCH("link_tlm_encode", ITERATIONS, tlm_encode(&sample_rec, &s, rec, sizeof(rec)));
+    harness_conf_u32("link_wire_bytes", link.stats.tx_wire / ITERATIONS);
+}
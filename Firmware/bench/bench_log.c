@@ -0,0 +1,32 @@
+/**
+ * @file   bench_log.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Cost of a tokenized log call, drain excluded.
+ */
+
+#include "log.h"
+#include "bench.h"
+
+#define ITERATIONS  40              /* 4 words each, fits in the ring */
+
+static uint32_t drain[LOG_RING_WORDS];
+
+void bench_log(void)
+{
+    log_stats_t stats;
+    volatile uint32_t a = 1, b = 2;
+
+    log_init();
+    BENCH("log_info_0", ITERATIONS, LOG_INFO("tick"));
+    log_read(drain, LOG_RING_WORDS);
+    BENCH("log_info_2", ITERATIONS, LOG_INFO("a %u b %u", a, b));
+    log_read(drain, LOG_RING_WORDS);
+
+    // full ring: the cost of counting a drop
+    for (uint32_t i = 0; i <= LOG_RING_WORDS / 3; ++i)
+        LOG_INFO("fill %u", a);
+    BENCH("log_info_dropped", ITERATIONS, LOG_INFO("a %u b %u", a, b));
+    log_stats(&stats);
+    harness_conf_u32("log_dropped", stats.dropped);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file   bench_main.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Entry point of the benchmark image (make bench).
+ */
+
+#include "semihost.h"
+#include "bench.h"
+
+extern uint32_t startup_data_cycles;
+extern uint32_t startup_data_lz_bytes;
+extern uint32_t _sdata, _edata;
+
+/**
+ * @brief Build "<prefix><n><suffix>" for benchmarks with a size parameter.
+ * @note  Returns a static buffer, valid until the next call.
+ */
+const char *bench_name(const char *prefix, uint32_t n, const char *suffix)
+{
+    static char name[48];
+    char digits[11];
+    char *d = &digits[10];
+    char *p = name;
+    char *end = &name[sizeof(name) - 1];
+
+    *d = '\0';
+    do {
+        *--d = '0' + n % 10;
+        n /= 10;
+    } while (n);
+
+    while (*prefix && p < end)
+        *p++ = *prefix++;
+    while (*d && p < end)
+        *p++ = *d++;
+    while (*suffix && p < end)
+        *p++ = *suffix++;
+    *p = '\0';
+    return name;
+}
+
+/**
+ * @brief Cost of the timing itself, subtract it from short benchmarks.
+ */
+static void bench_overhead(void)
+{
+    BENCH("timer_overhead", 1000, bench_clobber());
+}
+
+int main(void)
+{
+    harness_init();
+
+    harness_conf("profile", BUILD_PROFILE);
+#ifdef BOARD_QEMU
+    harness_conf("board", "qemu");
+#else
+    harness_conf("board", "stm32f107");
+#endif
+    harness_conf_u32("clock_hz", CORE_CLOCK_HZ);
+    harness_conf_u32("data_bytes", (uint32_t) &_edata - (uint32_t) &_sdata);
+    harness_conf_u32("data_lz_bytes", startup_data_lz_bytes);
+    harness_conf_u32("startup_data_cycles", startup_data_cycles);
+
+    bench_overhead();
+    bench_mem();
+    bench_crc();
+    bench_irq();
+    bench_ctxsw();
+    bench_gpio();
+    bench_exec();
+    bench_dsp();
+    bench_swtimer();
+    bench_log();
+    bench_prof();
+    bench_reg();
+    bench_defer();
+    bench_link();
+    bench_cpuacct();
+
+    semihost_puts("DONE  0 0\n");
+    semihost_exit(0);
+}
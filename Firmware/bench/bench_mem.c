@@ -0,0 +1,66 @@
+/**
+ * @file   bench_mem.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  memcpy / memset benchmarks.
+ */
+
+#include <string.h>
+#include "bench.h"
+
+#define BUF_SIZE    4096
+#define ITERATIONS  100
+
+static uint8_t src_buf[BUF_SIZE + 8] __attribute__((aligned(8)));
+static uint8_t dst_buf[BUF_SIZE + 8] __attribute__((aligned(8)));
+
+static const uint32_t lengths[] = { 16, 64, 256, 1024, 4096 };
+
+/* Stop GCC from turning the reference loops back into library calls. */
+#define NO_LIBCALL  __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+
+static NO_LIBCALL void copy_bytes(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    while (len--)
+        *dst++ = *src++;
+}
+
+static NO_LIBCALL void copy_words(uint32_t *dst, const uint32_t *src, size_t len)
+{
+    for (len /= 4; len; --len)
+        *dst++ = *src++;
+}
+
+static NO_LIBCALL void set_bytes(uint8_t *dst, uint8_t value, size_t len)
+{
+    while (len--)
+        *dst++ = value;
+}
+
+void bench_mem(void)
+{
+    for (uint32_t i = 0; i < sizeof(src_buf); ++i)
+        src_buf[i] = i;
+
+    for (uint32_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        uint32_t len = lengths[i];
+
+        BENCH(bench_name("memcpy_", len, "_aligned"), ITERATIONS,
+              memcpy(dst_buf, src_buf, len); bench_clobber());
+        BENCH(bench_name("memcpy_", len, "_misaligned"), ITERATIONS,
+              memcpy(&dst_buf[1], &src_buf[3], len); bench_clobber());
+        BENCH(bench_name("memmove_", len, "_overlap"), ITERATIONS,
+              memmove(&dst_buf[4], dst_buf, len); bench_clobber());
+        BENCH(bench_name("copy_bytes_", len, ""), ITERATIONS,
+              copy_bytes(dst_buf, src_buf, len); bench_clobber());
+        BENCH(bench_name("copy_words_", len, ""), ITERATIONS,
+              copy_words((uint32_t *) dst_buf, (const uint32_t *) src_buf, len);
+              bench_clobber());
+        BENCH(bench_name("memset_", len, "_aligned"), ITERATIONS,
+              memset(dst_buf, 0x5A, len); bench_clobber());
+        BENCH(bench_name("memset_", len, "_misaligned"), ITERATIONS,
+              memset(&dst_buf[1], 0x5A, len); bench_clobber());
+        BENCH(bench_name("set_bytes_", len, ""), ITERATIONS,
+              set_bytes(dst_buf, 0x5A, len); bench_clobber());
+    }
+}
@@ -0,0 +1,39 @@
+/**
+ * @file   bench_prof.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Profiler overhead: the same loop with and without sampling.
+ *
+ * TIM7 only exists on the board, under QEMU this is skipped.
+ */
+
+#include "prof.h"
+#include "bench.h"
+
+#define RATE_HZ     10000
+#define ITERATIONS  100000
+
+void bench_prof(void)
+{
+#ifndef BOARD_QEMU
+    uint32_t start, off, on;
+
+    start = harness_cycles();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_clobber();
+    off = harness_cycles() - start;
+
+    // APB1 is not divided after reset, TIM7 runs at the core clock
+    prof_start(CORE_CLOCK_HZ, RATE_HZ);
+    start = harness_cycles();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_clobber();
+    on = harness_cycles() - start;
+    prof_stop();
+
+    harness_bench("prof_loop_off", ITERATIONS, off);
+    harness_bench("prof_loop_10khz", ITERATIONS, on);
+    // cycles per sample; the overhead is that times the rate over the clock
+    harness_bench("prof_sample", prof.count + prof.dropped, on - off);
+#endif
+}
@@ -0,0 +1,39 @@
+/**
+ * @file   bench_reg.cpp
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Pin reconfiguration and toggling (PC13), written field by field
+ *         in C and through the C++ register layer.
+ */
+
+#include "stm32f107xc.hpp"
+
+extern "C" {
+#include "bench.h"
+}
+
+#define ITERATIONS  1000
+
+using namespace stm32;
+
+extern "C" void bench_reg(void)
+{
+    rcc::APB2ENR::set<rcc::IOPCEN>();
+
+    // clear MODE13 and CNF13, then set each: four loads, four stores
+    BENCH("reg_crh_c", ITERATIONS,
+          PORTC->CRH &= ~(3u << 20);
+          PORTC->CRH &= ~(3u << 22);
+          PORTC->CRH |= (2u << 20);
+          PORTC->CRH |= (0u << 22));
+    BENCH("reg_crh_modify", ITERATIONS,
+          gpio::PC::CRH::modify(gpio::MODE<13>::is<gpio::OUT_2MHZ>(),
+                                gpio::CNF<13>::is<gpio::PUSH_PULL>()));
+
+    // gpio.c style set and reset, a load and a store each
+    BENCH("reg_toggle_c", ITERATIONS,
+          PORTC->BSRR |= (1u << 13); PORTC->BRR |= (1u << 13));
+    BENCH("reg_toggle_write", ITERATIONS,
+          gpio::PC::BSRR::write(gpio::BS<13>::set());
+          gpio::PC::BSRR::write(gpio::BR<13>::set()));
+}
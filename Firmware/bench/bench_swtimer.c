@@ -0,0 +1,41 @@
+/**
+ * @file   bench_swtimer.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Timing-wheel timer costs with a loaded wheel.
+ */
+
+#include "swtimer.h"
+#include "bench.h"
+
+#define TIMERS      256
+#define ITERATIONS  1000
+
+static swtimer_t timers[TIMERS];
+static swtimer_t probe;
+static volatile uint32_t expired;
+
+static void count_fn(void *arg)
+{
+    (void) arg;
+    expired++;
+}
+
+void bench_swtimer(void)
+{
+    swtimer_init();
+    for (uint32_t i = 0; i < TIMERS; ++i) {
+        swtimer_setup(&timers[i], count_fn, 0);
+        swtimer_start(&timers[i], 1 + i * 37 % 5000, 1 + i * 13 % 200, 0);
+    }
+    swtimer_setup(&probe, count_fn, 0);
+
+    // O(1): the cost must not depend on how many timers are running
+    BENCH("swtimer_start_stop_l0", ITERATIONS,
+          swtimer_start(&probe, 10, 0, 0); swtimer_stop(&probe));
+    BENCH("swtimer_start_stop_l2", ITERATIONS,
+          swtimer_start(&probe, 100000, 0, 0); swtimer_stop(&probe));
+    BENCH("swtimer_tick_poll", ITERATIONS,
+          swtimer_tick(); swtimer_poll());
+    harness_conf_u32("swtimer_expired", expired);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file   boot_main.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  A/B slot bootloader (make boot).
+ *
+ * Starts the valid image with the highest sequence number, see image.h.
+ * Without a valid image it stays here and blinks the LED.
+ */
+
+#include "core_cm3.h"
+#include "crc.h"
+#include "gpio.h"
+#include "image.h"
+
+/**
+ * @brief Switch to the image's vector table and stack, enter its reset
+ *        handler. Does not return.
+ */
+static void boot_jump(uint32_t vectors)
+{
+    uint32_t sp = ((const uint32_t *) vectors)[0];
+    uint32_t pc = ((const uint32_t *) vectors)[1];
+
+    SCB_VTOR = vectors;
+    __asm__ volatile (
+        "dsb            \n"
+        "isb            \n"
+        "msr    msp, %0 \n"
+        "bx     %1      \n"
+        : : "r" (sp), "r" (pc) : "memory"
+    );
+    while (1) ;
+}
+
+int main(void)
+{
+    crc_init();
+
+    uint32_t slot = image_select();
+    if (slot)
+        boot_jump(IMAGE_VECTORS(slot));
+
+    gpio_init();
+    while (1) {
+        gpio_off();
+        delay_();
+        gpio_on();
+        delay_();
+    }
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file   board_qemu.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Board support shim for running under qemu-system-arm.
+ */
+
+#include "stm32f107xc.h"
+#include "flash.h"
+#include "image.h"
+
+RCC_TypeDef  qemu_rcc;
+GPIO_TypeDef qemu_gpio[5];
+IWDG_TypeDef qemu_iwdg;
+WWDG_TypeDef qemu_wwdg;
+AFIO_TypeDef qemu_afio;
+ETH_TypeDef  qemu_eth;
+TIM_TypeDef  qemu_tim7;
+FLASH_TypeDef qemu_flash;
+
+uint8_t qemu_storage[STORAGE_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
+uint8_t qemu_slots[2 * SLOT_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
+uint32_t qemu_running_slot;
+uint32_t qemu_dwt[6];
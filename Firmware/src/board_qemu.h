@@ -0,0 +1,66 @@
+/**
+ * @file   board_qemu.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Board support shim for running under qemu-system-arm.
+ *
+ * QEMU has no STM32F107 machine. The test image runs on the Cortex-M3
+ * "mps2-an385" machine instead, which has none of the STM32 peripherals,
+ * so the ones the firmware touches are redirected to RAM-backed register
+ * images. Included by stm32f107xc.h when BOARD_QEMU is defined.
+ */
+
+#ifndef __BOARD_QEMU_H
+#define __BOARD_QEMU_H
+
+extern RCC_TypeDef  qemu_rcc;
+extern GPIO_TypeDef qemu_gpio[5];
+extern IWDG_TypeDef qemu_iwdg;
+extern WWDG_TypeDef qemu_wwdg;
+extern AFIO_TypeDef qemu_afio;
+extern ETH_TypeDef  qemu_eth;
+extern TIM_TypeDef  qemu_tim7;
+extern FLASH_TypeDef qemu_flash;
+
+/* Stands in for the storage pages in flash, see flash.c and kv.c. */
+extern uint8_t qemu_storage[];
+
+/* Stand in for the A/B slots in flash, and the slot the image "runs"
+ * from, see image.h and fwupdate.c. */
+extern uint8_t qemu_slots[];
+extern uint32_t qemu_running_slot;
+
+/* DWT_CYCCNT .. DWT_FOLDCNT, which QEMU does not count, see cpuacct.c. */
+extern uint32_t qemu_dwt[6];
+
+#undef  RCC
+#define RCC                 (&qemu_rcc)
+
+#undef  IWDG
+#undef  WWDG
+#define IWDG                (&qemu_iwdg)
+#define WWDG                (&qemu_wwdg)
+
+#undef  AFIO
+#undef  ETHERNET
+#define AFIO                (&qemu_afio)
+#define ETHERNET            (&qemu_eth)
+
+#undef  TIM7
+#define TIM7                (&qemu_tim7)
+
+#undef  FLASH_IT
+#define FLASH_IT            (&qemu_flash)
+
+#undef  PORTA
+#undef  PORTB
+#undef  PORTC
+#undef  PORTD
+#undef  PORTE
+#define PORTA               (&qemu_gpio[0])
+#define PORTB               (&qemu_gpio[1])
+#define PORTC               (&qemu_gpio[2])
+#define PORTD               (&qemu_gpio[3])
+#define PORTE               (&qemu_gpio[4])
+
+#endif /* __BOARD_QEMU_H */
@@ -0,0 +1,37 @@
+/**
+ * @file   compiler.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Compiler specific attributes.
+ */
+
+#ifndef __COMPILER_H
+#define __COMPILER_H
+
+/**
+ * Place a function in SRAM. The reset handler copies it there together
+ * with .data. long_call is required because SRAM is out of BL range
+ * from flash.
+ */
+#define __RAMFUNC   __attribute__((section(".ramfunc"), noinline, long_call))
+
+/**
+ * Define the exception handler `handler` to pass the stack frame of the
+ * interrupted code (r0-r3, r12, lr, pc, xpsr), from whichever stack it
+ * was on, to `void c_func(const uint32_t *frame)`. The branch is
+ * c_func's only caller and LTO does not see it, so c_func must be
+ * __attribute__((used)).
+ */
+#define EXC_FRAME_TRAMPOLINE(handler, c_func)                   \
+    __attribute__((naked)) void handler(void)                   \
+    {                                                           \
+        __asm__ volatile (                                      \
+            "tst    lr, #4                  \n"                 \
+            "ite    eq                      \n"                 \
+            "mrseq  r0, msp                 \n"                 \
+            "mrsne  r0, psp                 \n"                 \
+            "b      " #c_func "             \n"                 \
+        );                                                      \
+    }
+
+#endif /* __COMPILER_H */
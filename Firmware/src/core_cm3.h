@@ -234,4 +234,92 @@
 #define SCS_ICTR                (*(volatile uint32_t *)0xE000E004)
 #define SCS_ACTLR               (*(volatile uint32_t *)0xE000E008)
 
+/**
+ * Cortex-M3 Debug
+ *
+ * Reference:
+ *   Filename: DDI0403E_d_armv7m_arm.pdf
+ *   Chapter:  C1.6 Debug system registers
+ */
+#define DHCSR               (*(volatile uint32_t *)0xE000EDF0)
+#define DCRSR               (*(volatile uint32_t *)0xE000EDF4)
+#define DCRDR               (*(volatile uint32_t *)0xE000EDF8)
+#define DEMCR               (*(volatile uint32_t *)0xE000EDFC)
+
+// DEMCR
+#define DEMCR_TRCENA        (1 << 24)
+
+/**
+ * Cortex-M3 DWT
+ *
+ * Reference:
+ *   Filename: DDI0403E_d_armv7m_arm.pdf
+ *   Chapter:  C1.8 The Data Watchpoint and Trace unit
+ *
+ * The DWT is only clocked when DEMCR.TRCENA is set.
+ */
+#define DWT_CTRL            (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT          (*(volatile uint32_t *)0xE0001004)
+#define DWT_CPICNT          (*(volatile uint32_t *)0xE0001008)
+#define DWT_EXCCNT          (*(volatile uint32_t *)0xE000100C)
+#define DWT_SLEEPCNT        (*(volatile uint32_t *)0xE0001010)
+#define DWT_LSUCNT          (*(volatile uint32_t *)0xE0001014)
+#define DWT_FOLDCNT         (*(volatile uint32_t *)0xE0001018)
+
+// DWT_CTRL
+#define DWT_CTRL_CYCCNTENA  (1 << 0)
+#define DWT_CTRL_CPIEVTENA  (1 << 17)
+#define DWT_CTRL_EXCEVTENA  (1 << 18)
+#define DWT_CTRL_SLEEPEVTENA (1 << 19)
+#define DWT_CTRL_LSUEVTENA  (1 << 20)
+#define DWT_CTRL_FOLDEVTENA (1 << 21)
+
+/*
+ * The event counters are 8 bits wide and wrap:
+ *   CPICNT    extra cycles of multi-cycle instructions, other than LSU
+ *   EXCCNT    cycles of exception entry and exit
+ *   SLEEPCNT  cycles asleep
+ *   LSUCNT    extra cycles of loads and stores
+ *   FOLDCNT   instructions folded, one cycle each saved
+ * Instructions = CYCCNT - CPICNT - EXCCNT - SLEEPCNT - LSUCNT + FOLDCNT.
+ */
+
+/* Start CYCCNT. QEMU has no DWT: nothing to do under BOARD_QEMU. */
+static inline void dwt_enable(void)
+{
+#ifndef BOARD_QEMU
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+/* CYCCNT, 0 under BOARD_QEMU. */
+static inline uint32_t dwt_cycles(void)
+{
+#ifdef BOARD_QEMU
+    return 0;
+#else
+    return DWT_CYCCNT;
+#endif
+}
+
+/**
+ * Cortex-M3 ITM
+ *
+ * Reference:
+ *   Filename: DDI0403E_d_armv7m_arm.pdf
+ *   Chapter:  C1.7 The Instrumentation Trace Macrocell
+ *
+ * A stimulus port reads 1 when it can take another write.
+ */
+#define ITM_STIM            ( (volatile uint32_t *)0xE0000000)
+#define ITM_STIM0           (*(volatile uint32_t *)0xE0000000)
+#define ITM_TER             (*(volatile uint32_t *)0xE0000E00)
+#define ITM_TPR             (*(volatile uint32_t *)0xE0000E40)
+#define ITM_TCR             (*(volatile uint32_t *)0xE0000E80)
+#define ITM_LAR             (*(volatile uint32_t *)0xE0000FB0)
+
+// ITM_TCR
+#define ITM_TCR_ITMENA      (1 << 0)
+
 #endif /* __CORE_CM3_H */
\ No newline at end of file
@@ -0,0 +1,240 @@
+/**
+ * @file   cpuacct.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Per-context CPU accounting.
+ *
+ * CYCCNT .. FOLDCNT are six consecutive words, a snapshot is six loads.
+ * `mark` is the snapshot of the last switch, the next switch charges the
+ * difference to the context on top of the stack.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "stm32f107xc.h"
+#include "cpuacct.h"
+
+#ifdef BOARD_QEMU
+#define DWT_COUNTERS        ((volatile uint32_t *) qemu_dwt)
+#else
+#define DWT_COUNTERS        (&DWT_CYCCNT)
+#endif
+
+#define DWT_CTRL_EVENTS     (DWT_CTRL_CPIEVTENA | DWT_CTRL_EXCEVTENA | \
+                             DWT_CTRL_SLEEPEVTENA | DWT_CTRL_LSUEVTENA | \
+                             DWT_CTRL_FOLDEVTENA)
+
+static cpuacct_ctx_t other;
+static cpuacct_ctx_t idle;
+static cpuacct_ctx_t *stack[CPUACCT_DEPTH];
+static uint32_t depth;
+static uint32_t skipped;                    /* enters not pushed */
+static cpuacct_counts_t mark;
+static uint32_t report_at;                  /* CYCCNT */
+static cpuacct_stats_t stats;
+
+static inline uint32_t irq_save(void)
+{
+    uint32_t primask;
+
+    __asm__ volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline void irq_restore(uint32_t primask)
+{
+    __asm__ volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+static inline void cpuacct_sample(cpuacct_counts_t *n)
+{
+    volatile uint32_t *dwt = DWT_COUNTERS;
+
+    n->cycles = dwt[0];
+    n->cpi = dwt[1];
+    n->exc = dwt[2];
+    n->sleep = dwt[3];
+    n->lsu = dwt[4];
+    n->fold = dwt[5];
+}
+
+/* Charge what the counters moved since `mark` to the context on top. */
+static void cpuacct_charge(void)
+{
+    cpuacct_counts_t now;
+    cpuacct_counts_t *t = &stack[depth - 1]->total;
+
+    cpuacct_sample(&now);
+    uint32_t cycles = now.cycles - mark.cycles;
+    t->cycles += cycles;
+
+    // an event counter moves at most once a cycle, so it cannot have
+    // wrapped within fewer than 256 cycles; longer spans are not counted
+    if (cycles < 256) {
+        t->counted += cycles;
+        t->cpi += (uint8_t) (now.cpi - mark.cpi);
+        t->exc += (uint8_t) (now.exc - mark.exc);
+        t->sleep += (uint8_t) (now.sleep - mark.sleep);
+        t->lsu += (uint8_t) (now.lsu - mark.lsu);
+        t->fold += (uint8_t) (now.fold - mark.fold);
+    }
+    mark = now;
+}
+
+void cpuacct_init(void)
+{
+    dwt_enable();
+#ifndef BOARD_QEMU
+    DWT_CTRL |= DWT_CTRL_EVENTS;
+#endif
+    memset(&stats, 0, sizeof(stats));
+    cpuacct_setup(&other, "other", CPUACCT_STAGE);
+    cpuacct_setup(&idle, "idle", CPUACCT_IDLE);
+    other.next = &idle;
+    idle.next = 0;
+
+    stack[0] = &other;
+    depth = 1;
+    skipped = 0;
+    cpuacct_sample(&mark);
+    report_at = mark.cycles;
+}
+
+/**
+ * @brief Add `c` to the report, once, after cpuacct_init().
+ * @param kind CPUACCT_STAGE, CPUACCT_IRQ or CPUACCT_IDLE.
+ */
+void cpuacct_setup(cpuacct_ctx_t *c, const char *name, uint32_t kind)
+{
+    memset(c, 0, sizeof(*c));
+    c->name = name;
+    c->kind = kind;
+
+    if (c != &other && c != &idle) {
+        cpuacct_ctx_t *p = &idle;
+        while (p->next)
+            p = p->next;
+        p->next = c;
+    }
+}
+
+/**
+ * @brief `c` starts running, on top of whatever ran until now.
+ */
+void cpuacct_enter(cpuacct_ctx_t *c)
+{
+    uint32_t primask = irq_save();
+
+    if (depth == CPUACCT_DEPTH) {
+        // its cycles stay with the context below
+        skipped++;
+        stats.overflows++;
+    } else {
+        cpuacct_charge();
+        c->entries++;
+        stack[depth++] = c;
+    }
+    irq_restore(primask);
+}
+
+/**
+ * @brief `c` is done, the context below it runs again.
+ */
+void cpuacct_exit(cpuacct_ctx_t *c)
+{
+    uint32_t primask = irq_save();
+
+    if (skipped) {
+        skipped--;
+    } else if (depth > 1) {
+        cpuacct_charge();
+        if (stack[--depth] != c)
+            stats.mismatches++;
+    } else {
+        stats.mismatches++;
+    }
+    irq_restore(primask);
+}
+
+/**
+ * @brief Sleep until the next interrupt, as the idle context.
+ */
+void cpuacct_idle(void)
+{
+    cpuacct_enter(&idle);
+#ifndef BOARD_QEMU
+    __asm__ volatile ("wfi" : : : "memory");
+#endif
+    cpuacct_exit(&idle);
+}
+
+static void counts_add(cpuacct_counts_t *sum, const cpuacct_counts_t *n)
+{
+    sum->cycles += n->cycles;
+    sum->counted += n->counted;
+    sum->cpi += n->cpi;
+    sum->exc += n->exc;
+    sum->sleep += n->sleep;
+    sum->lsu += n->lsu;
+    sum->fold += n->fold;
+}
+
+static uint16_t per_mille(uint32_t part, uint32_t whole)
+{
+    return whole ? (uint64_t) part * 1000 / whole : 0;
+}
+
+/**
+ * @brief End the report window: each context's `total` moves to `last`,
+ *        `r` gets the sums. Call it periodically, at least once every
+ *        2^32 cycles (59 s at 72 MHz). The window ends for all contexts
+ *        at once, with interrupts masked for a few cycles per context.
+ */
+void cpuacct_report(cpuacct_report_t *r)
+{
+    cpuacct_counts_t all = { 0 };
+    uint32_t idle_cycles = 0;
+    uint32_t irq_cycles = 0;
+    uint32_t primask = irq_save();
+
+    // the running contexts get what they did up to now, and nothing is
+    // charged between that and the moves: the contexts sum to the window
+    cpuacct_charge();
+    r->window = mark.cycles - report_at;
+    report_at = mark.cycles;
+    for (cpuacct_ctx_t *c = &other; c; c = c->next) {
+        c->last = c->total;
+        c->last_entries = c->entries;
+        memset(&c->total, 0, sizeof(c->total));
+        c->entries = 0;
+    }
+    irq_restore(primask);
+
+    for (cpuacct_ctx_t *c = &other; c; c = c->next) {
+        counts_add(&all, &c->last);
+        if (c->kind == CPUACCT_IDLE)
+            idle_cycles += c->last.cycles;
+        else if (c->kind == CPUACCT_IRQ)
+            irq_cycles += c->last.cycles;
+    }
+
+    r->idle = idle_cycles;
+    r->busy = r->window > idle_cycles ? r->window - idle_cycles : 0;
+    r->irq = irq_cycles;
+    r->counted = all.counted;
+    r->exc = all.exc;
+    r->stall = all.cpi + all.lsu;
+    r->sleep = all.sleep;
+    r->load_pm = per_mille(r->busy, r->window);
+    r->irq_pm = per_mille(irq_cycles + all.exc, r->window);
+}
+
+void cpuacct_stats(cpuacct_stats_t *s)
+{
+    *s = stats;
+}
+
+const cpuacct_ctx_t *cpuacct_contexts(void)
+{
+    return &other;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file   cpuacct.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Per-context CPU accounting from the DWT cycle and event
+ *         counters: where the cycles go, and why.
+ *
+ *     static cpuacct_ctx_t eth_ctx, dsp_ctx;
+ *     static cpuacct_report_t load;
+ *
+ *     cpuacct_init();
+ *     cpuacct_setup(&eth_ctx, "eth", CPUACCT_IRQ);
+ *     cpuacct_setup(&dsp_ctx, "dsp", CPUACCT_STAGE);
+ *
+ *     void ETH_Handler(void)
+ *     {
+ *         cpuacct_enter(&eth_ctx);
+ *         ...
+ *         cpuacct_exit(&eth_ctx);
+ *     }
+ *
+ *     while (1) {
+ *         cpuacct_enter(&dsp_ctx);
+ *         dsp_process();
+ *         cpuacct_exit(&dsp_ctx);
+ *         if (once_a_second())
+ *             cpuacct_report(&load);       // load.load_pm, load.irq_pm ...
+ *         cpuacct_idle();                  // WFI
+ *     }
+ *
+ * The running contexts form a stack: the main loop outside any stage
+ * ("other") at the bottom, a stage above it, interrupt handlers above
+ * that as they nest. Every enter and exit reads CYCCNT and the five event
+ * counters and charges what they moved since the last read to the
+ * context on top. So each cycle is charged to exactly one context, a
+ * handler's cycles are not counted in the stage it interrupted, and the
+ * per-context cycles of a report add up to its window.
+ *
+ * The event counters are 8 bits wide and wrap. Each moves at most once
+ * a cycle, so their differences are exact over a span of fewer than 256
+ * cycles between two reads. Only such spans are counted: `cpi` .. `fold`
+ * cover the `counted` cycles of a context, not all its `cycles`. That is
+ * all of a short handler, and little of a long stage or of idle. Idle
+ * time therefore comes from the cycles of the idle contexts, not from
+ * SLEEPCNT.
+ *
+ * cpuacct_enter() and cpuacct_exit() mask interrupts while they run,
+ * about 40 cycles each (bench_cpuacct measures it). The counts go to
+ * `total` and cpuacct_report() moves them to `last`.
+ */
+
+#ifndef __CPUACCT_H
+#define __CPUACCT_H
+
+#include <stdint.h>
+
+#ifndef CPUACCT_DEPTH
+#define CPUACCT_DEPTH       8               /* nesting, with "other" */
+#endif
+
+// context kinds
+#define CPUACCT_STAGE       0               /* main loop stage */
+#define CPUACCT_IRQ         1               /* interrupt handler */
+#define CPUACCT_IDLE        2               /* counts as free */
+
+/* cpi .. fold: in the `counted` cycles only, see above. */
+typedef struct
+{
+    uint32_t cycles;                        /* CYCCNT */
+    uint32_t counted;                       /* in spans under 256 cycles */
+    uint32_t cpi;                           /* multi-cycle instructions */
+    uint32_t exc;                           /* exception entry and exit */
+    uint32_t sleep;
+    uint32_t lsu;                           /* load and store stalls */
+    uint32_t fold;                          /* folded instructions */
+} cpuacct_counts_t;
+
+typedef struct cpuacct_ctx
+{
+    const char *name;
+    uint32_t kind;
+    uint32_t entries;                       /* since the last report */
+    uint32_t last_entries;
+    cpuacct_counts_t total;                 /* since the last report */
+    cpuacct_counts_t last;                  /* in the last report window */
+    struct cpuacct_ctx *next;
+} cpuacct_ctx_t;
+
+typedef struct
+{
+    uint32_t window;                        /* cycles since the last report */
+    uint32_t busy;                          /* window - idle */
+    uint32_t idle;                          /* in CPUACCT_IDLE contexts */
+    uint32_t irq;                           /* in CPUACCT_IRQ contexts */
+    uint32_t counted;                       /* cycles exc .. sleep cover */
+    uint32_t exc;                           /* in `counted` cycles only */
+    uint32_t stall;                         /* cpi + lsu, same */
+    uint32_t sleep;                         /* same */
+    uint16_t load_pm;                       /* busy, per mille of window */
+    uint16_t irq_pm;                        /* irq + exc, per mille */
+} cpuacct_report_t;
+
+typedef struct
+{
+    uint32_t overflows;                     /* enters beyond CPUACCT_DEPTH */
+    uint32_t mismatches;                    /* exit of another context */
+} cpuacct_stats_t;
+
+void cpuacct_init(void);
+void cpuacct_setup(cpuacct_ctx_t *c, const char *name, uint32_t kind);
+void cpuacct_enter(cpuacct_ctx_t *c);
+void cpuacct_exit(cpuacct_ctx_t *c);
+void cpuacct_idle(void);
+void cpuacct_report(cpuacct_report_t *r);
+void cpuacct_stats(cpuacct_stats_t *stats);
+
+/* All contexts, "other" and "idle" first, linked by `next`. */
+const cpuacct_ctx_t *cpuacct_contexts(void);
+
+/* Instructions executed in the `counted` cycles. */
+static inline uint32_t cpuacct_instructions(const cpuacct_counts_t *n)
+{
+    return n->counted - n->cpi - n->exc - n->sleep - n->lsu + n->fold;
+}
+
+#endif /* __CPUACCT_H */
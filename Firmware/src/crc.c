@@ -0,0 +1,66 @@
+/**
+ * @file   crc.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  CRC-32 calculation (hardware CRC unit and software).
+ */
+
+#include "stm32f107xc.h"
+#include "crc.h"
+
+#define CRC32_POLY  0x04C11DB7
+
+/**
+ * @brief Nibble-wise lookup table, small enough to keep in flash.
+ */
+static const uint32_t crc32_table[16] = {
+    0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9,
+    0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+    0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61,
+    0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD,
+};
+
+void crc_init(void)
+{
+    RCC->AHBENR |= (1 << CRCEN);
+}
+
+#ifndef BOARD_QEMU
+uint32_t crc32_hw(const uint32_t *data, size_t words)
+{
+    CRC->CR = CRC_CR_RESET;
+    while (words--)
+        CRC->DR = *data++;
+    return CRC->DR;
+}
+#else
+/* QEMU has no CRC unit, fall back to the bit-exact software version. */
+uint32_t crc32_hw(const uint32_t *data, size_t words)
+{
+    return crc32_sw(data, words);
+}
+#endif
+
+uint32_t crc32_sw(const uint32_t *data, size_t words)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (words--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; ++i)
+            crc = (crc << 4) ^ crc32_table[crc >> 28];
+    }
+    return crc;
+}
+
+uint32_t crc32_sw_bitwise(const uint32_t *data, size_t words)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (words--) {
+        crc ^= *data++;
+        for (int i = 0; i < 32; ++i)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ CRC32_POLY : (crc << 1);
+    }
+    return crc;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file   crc.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  CRC-32 calculation (hardware CRC unit and software).
+ *
+ * Both variants compute what the STM32 CRC unit computes: polynomial
+ * 0x04C11DB7, initial value 0xFFFFFFFF, 32-bit words fed MSB first, no
+ * reflection and no final XOR.
+ */
+
+#ifndef __CRC_H
+#define __CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// RCC AHBENR
+#define CRCEN   6
+
+// CRC_CR
+#define CRC_CR_RESET    (1 << 0)
+
+void crc_init(void);
+uint32_t crc32_hw(const uint32_t *data, size_t words);
+uint32_t crc32_sw(const uint32_t *data, size_t words);
+uint32_t crc32_sw_bitwise(const uint32_t *data, size_t words);
+
+#endif /* __CRC_H */
@@ -0,0 +1,171 @@
+/**
+ * @file   defer.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Deferred work queues.
+ *
+ * Each priority has a ring of item pointers, many producers and one
+ * consumer, the same scheme as the log ring: a producer reserves a slot
+ * by moving `head` with LDREX/STREX, then stores the pointer. The
+ * consumer takes slots until it finds one not stored yet and clears
+ * what it took. A producer it overtakes that way pends the dispatcher
+ * again once it has stored, so nothing is left behind.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "defer.h"
+
+#define QUEUE_MASK          (DEFER_QUEUE_LEN - 1)
+
+#if DEFER_QUEUE_LEN & QUEUE_MASK
+#error "DEFER_QUEUE_LEN must be a power of 2"
+#endif
+
+// SCB_ICSR
+#define ICSR_PENDSVSET      (1UL << 28)
+
+// SCB_SHPR, PendSV is exception 14
+#define SHPR_PENDSV         (14 - 4)
+
+typedef struct
+{
+    defer_work_t *slot[DEFER_QUEUE_LEN];
+    uint32_t head;                          /* next slot to reserve */
+    uint32_t tail;                          /* next slot to take */
+} queue_t;
+
+static queue_t queues[DEFER_PRIOS];
+static defer_info_t info;
+static int use_pendsv;
+
+static inline void defer_kick(void)
+{
+#ifndef BOARD_QEMU
+    if (use_pendsv)
+        SCB_ICSR = ICSR_PENDSVSET;
+#endif
+}
+
+/**
+ * @param mode DEFER_PENDSV or DEFER_MAIN_LOOP.
+ */
+void defer_init(int mode)
+{
+    memset(queues, 0, sizeof(queues));
+    memset(&info, 0, sizeof(info));
+    use_pendsv = mode == DEFER_PENDSV;
+    dwt_enable();
+
+#ifndef BOARD_QEMU
+    // below every interrupt, so it runs when the last handler returns
+    SCB_SHPR[SHPR_PENDSV] = 0xFF;
+#endif
+}
+
+void defer_setup(defer_work_t *w, void (*fn)(void *arg), void *arg, uint32_t prio)
+{
+    memset(w, 0, sizeof(*w));
+    w->fn = fn;
+    w->arg = arg;
+    w->prio = prio < DEFER_PRIOS ? prio : DEFER_PRIOS - 1;
+}
+
+/**
+ * @brief Queue `w` to run, callable from any context.
+ * @return DEFER_OK, DEFER_PENDING if it is queued already, DEFER_FULL.
+ */
+int defer_post(defer_work_t *w)
+{
+    queue_t *q = &queues[w->prio];
+    uint32_t now = dwt_cycles();
+
+    __atomic_fetch_add(&w->stats.posts, 1, __ATOMIC_RELAXED);
+    if (__atomic_exchange_n(&w->pending, 1, __ATOMIC_ACQUIRE)) {
+        __atomic_fetch_add(&w->stats.coalesced, 1, __ATOMIC_RELAXED);
+        return DEFER_PENDING;
+    }
+    w->posted_at = now;
+
+    uint32_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    uint32_t tail;
+    do {
+        tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+        if (head - tail >= DEFER_QUEUE_LEN) {
+            __atomic_fetch_add(&w->stats.dropped, 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&w->pending, 0, __ATOMIC_RELEASE);
+            return DEFER_FULL;
+        }
+    } while (!__atomic_compare_exchange_n(&q->head, &head, head + 1, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    // statistics only, a racing post may lose an update
+    if (head + 1 - tail > info.depth_max[w->prio])
+        info.depth_max[w->prio] = head + 1 - tail;
+
+    __atomic_store_n(&q->slot[head & QUEUE_MASK], w, __ATOMIC_RELEASE);
+    defer_kick();
+    return DEFER_OK;
+}
+
+/* The oldest item of the highest priority that has one. */
+static defer_work_t *defer_take(void)
+{
+    for (uint32_t p = 0; p < DEFER_PRIOS; ++p) {
+        queue_t *q = &queues[p];
+        uint32_t tail = q->tail;
+        defer_work_t *w = __atomic_load_n(&q->slot[tail & QUEUE_MASK], __ATOMIC_ACQUIRE);
+
+        if (w) {
+            q->slot[tail & QUEUE_MASK] = 0;
+            __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+            return w;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Run queued work until the queues are empty. Priorities are
+ *        checked again after each item, work posted meanwhile at a
+ *        higher priority goes next.
+ * @return number of items run.
+ */
+int defer_run(void)
+{
+    defer_work_t *w;
+    int ran = 0;
+
+    while ((w = defer_take())) {
+        uint32_t start = dwt_cycles();
+        uint32_t latency = start - w->posted_at;
+
+        // from here on a post queues it again
+        __atomic_store_n(&w->pending, 0, __ATOMIC_RELEASE);
+        w->fn(w->arg);
+
+        uint32_t cycles = dwt_cycles() - start;
+        w->stats.runs++;
+        w->stats.cycles += cycles;
+        if (cycles > w->stats.cycles_max)
+            w->stats.cycles_max = cycles;
+        if (latency > w->stats.latency_max)
+            w->stats.latency_max = latency;
+        ++ran;
+    }
+    if (ran)
+        info.dispatches++;
+    return ran;
+}
+
+void defer_info(defer_info_t *i)
+{
+    *i = info;
+}
+
+#if !defined(BOARD_QEMU) && !defined(DEFER_NO_PENDSV)
+void PendSV_Handler(void)
+{
+    defer_run();
+}
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file   defer.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Deferred work: interrupt handlers queue the slow part of their
+ *         job and return, a dispatcher runs it later by priority.
+ *
+ *     static defer_work_t rx_work;
+ *
+ *     defer_init(DEFER_PENDSV);
+ *     defer_setup(&rx_work, rx_process, 0, 1);
+ *
+ *     void ETH_Handler(void)
+ *     {
+ *         ETHERNET->DMASR = ...;           // acknowledge
+ *         defer_post(&rx_work);            // the rest runs in PendSV
+ *     }
+ *
+ * There is one queue per priority, 0 runs first. A post is a dozen
+ * instructions and never blocks: the queues are lock-free and any
+ * context may post. An item is queued at most once, posting it again
+ * before it runs only counts in `coalesced`, so the work function must
+ * handle everything that came in since it last ran.
+ *
+ * DEFER_PENDSV dispatches from PendSV at the lowest exception priority,
+ * after the last nested handler returns. DEFER_MAIN_LOOP leaves it to
+ * defer_run() in the main loop. defer_run() must not be called from
+ * anywhere else: there is only one consumer. Define DEFER_NO_PENDSV when
+ * another module owns PendSV_Handler (bench_ctxsw.c).
+ *
+ * Each item counts its posts and runs and the cycles from post to start
+ * (latency) and from start to end (run time), from DWT_CYCCNT.
+ */
+
+#ifndef __DEFER_H
+#define __DEFER_H
+
+#include <stdint.h>
+
+#define DEFER_PRIOS         4
+#ifndef DEFER_QUEUE_LEN
+#define DEFER_QUEUE_LEN     16              /* per priority, power of 2 */
+#endif
+
+#define DEFER_MAIN_LOOP     0
+#define DEFER_PENDSV        1
+
+#define DEFER_OK            0
+#define DEFER_PENDING       1               /* already queued, coalesced */
+#define DEFER_FULL          (-1)            /* queue full, dropped */
+
+typedef struct
+{
+    uint32_t posts;
+    uint32_t coalesced;
+    uint32_t dropped;
+    uint32_t runs;
+    uint32_t cycles;                        /* total run time */
+    uint32_t cycles_max;
+    uint32_t latency_max;                   /* post to start */
+} defer_stats_t;
+
+typedef struct defer_work defer_work_t;
+
+struct defer_work
+{
+    void        (*fn)(void *arg);
+    void         *arg;
+    uint32_t      prio;
+    uint32_t      pending;                  /* queued and not started */
+    uint32_t      posted_at;
+    defer_stats_t stats;
+};
+
+typedef struct
+{
+    uint32_t dispatches;                    /* defer_run() calls that ran work */
+    uint32_t depth_max[DEFER_PRIOS];        /* deepest each queue has been */
+} defer_info_t;
+
+void defer_init(int mode);
+void defer_setup(defer_work_t *w, void (*fn)(void *arg), void *arg, uint32_t prio);
+int  defer_post(defer_work_t *w);
+int  defer_run(void);
+void defer_info(defer_info_t *info);
+
+#endif /* __DEFER_H */
@@ -0,0 +1,345 @@
+/**
+ * @file   dsp.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Fixed-point (Q15 / Q31) DSP kernels for the Cortex-M3.
+ */
+
+#include <string.h>
+#include "dsp.h"
+
+/* GCC turns these clamps into a single SSAT. */
+static inline q15_t sat_q15(int32_t x)
+{
+    if (x > INT16_MAX)
+        return INT16_MAX;
+    if (x < INT16_MIN)
+        return INT16_MIN;
+    return x;
+}
+
+static inline q31_t sat_q31(int64_t x)
+{
+    if (x > INT32_MAX)
+        return INT32_MAX;
+    if (x < INT32_MIN)
+        return INT32_MIN;
+    return x;
+}
+
+/**
+ * @brief Integer square root, bit by bit.
+ */
+static uint32_t isqrt32(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > v)
+        bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+/**
+ * @brief 12-bit right aligned ADC samples to signed Q15, mid-scale is 0.
+ */
+void dsp_adc_to_q15(const uint16_t *adc, q15_t *out, uint32_t n)
+{
+    while (n--)
+        *out++ = (q15_t) (((int32_t) *adc++ - 2048) * 16);
+}
+
+void dsp_fir_q15_init(dsp_fir_q15_t *fir, uint32_t num_taps,
+                      const q15_t *coeffs, q15_t *state)
+{
+    fir->num_taps = num_taps;
+    fir->coeffs = coeffs;
+    fir->state = state;
+    memset(state, 0, (num_taps - 1) * sizeof(q15_t));
+}
+
+/**
+ * @brief Block FIR, four outputs per pass over the coefficients.
+ *
+ * Each coefficient is loaded once per four outputs and the four sample
+ * windows slide through registers, so the inner loop does one
+ * coefficient load, one sample load and four SMLALs per tap.
+ */
+void dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t block)
+{
+    const uint32_t taps = fir->num_taps;
+    const q15_t *b = fir->coeffs;
+    q15_t *state = fir->state;
+    uint32_t k = 0;
+
+    memcpy(&state[taps - 1], in, block * sizeof(q15_t));
+
+    for (; k + 4 <= block; k += 4) {
+        const q15_t *x = &state[k + taps - 1];
+        int64_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+        int32_t s0 = x[0], s1 = x[1], s2 = x[2], s3 = x[3];
+
+        for (uint32_t i = 0; ; ) {
+            int32_t c = b[i];
+            acc0 += (int64_t) s0 * c;
+            acc1 += (int64_t) s1 * c;
+            acc2 += (int64_t) s2 * c;
+            acc3 += (int64_t) s3 * c;
+            if (++i == taps)
+                break;
+            s3 = s2;
+            s2 = s1;
+            s1 = s0;
+            s0 = x[-(int32_t) i];
+        }
+        out[k + 0] = sat_q15(acc0 >> 15);
+        out[k + 1] = sat_q15(acc1 >> 15);
+        out[k + 2] = sat_q15(acc2 >> 15);
+        out[k + 3] = sat_q15(acc3 >> 15);
+    }
+
+    for (; k < block; ++k) {
+        const q15_t *x = &state[k + taps - 1];
+        int64_t acc = 0;
+
+        for (uint32_t i = 0; i < taps; ++i)
+            acc += (int64_t) x[-(int32_t) i] * b[i];
+        out[k] = sat_q15(acc >> 15);
+    }
+
+    memmove(state, &state[block], (taps - 1) * sizeof(q15_t));
+}
+
+void dsp_fir_q31_init(dsp_fir_q31_t *fir, uint32_t num_taps,
+                      const q31_t *coeffs, q31_t *state)
+{
+    fir->num_taps = num_taps;
+    fir->coeffs = coeffs;
+    fir->state = state;
+    memset(state, 0, (num_taps - 1) * sizeof(q31_t));
+}
+
+/**
+ * @brief Block FIR, two outputs per pass (the 64-bit accumulators use
+ *        up the register file).
+ */
+void dsp_fir_q31(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t block)
+{
+    const uint32_t taps = fir->num_taps;
+    const q31_t *b = fir->coeffs;
+    q31_t *state = fir->state;
+    uint32_t k = 0;
+
+    memcpy(&state[taps - 1], in, block * sizeof(q31_t));
+
+    for (; k + 2 <= block; k += 2) {
+        const q31_t *x = &state[k + taps - 1];
+        int64_t acc0 = 0, acc1 = 0;
+        int32_t s0 = x[0], s1 = x[1];
+
+        for (uint32_t i = 0; ; ) {
+            int32_t c = b[i];
+            acc0 += (int64_t) s0 * c;
+            acc1 += (int64_t) s1 * c;
+            if (++i == taps)
+                break;
+            s1 = s0;
+            s0 = x[-(int32_t) i];
+        }
+        out[k + 0] = sat_q31(acc0 >> 31);
+        out[k + 1] = sat_q31(acc1 >> 31);
+    }
+
+    if (k < block) {
+        const q31_t *x = &state[k + taps - 1];
+        int64_t acc = 0;
+
+        for (uint32_t i = 0; i < taps; ++i)
+            acc += (int64_t) x[-(int32_t) i] * b[i];
+        out[k] = sat_q31(acc >> 31);
+    }
+
+    memmove(state, &state[block], (taps - 1) * sizeof(q31_t));
+}
+
+void dsp_biquad_q31_init(dsp_biquad_q31_t *bq, uint32_t num_stages,
+                         const q31_t *coeffs, q31_t *state, uint32_t post_shift)
+{
+    bq->num_stages = num_stages;
+    bq->coeffs = coeffs;
+    bq->state = state;
+    bq->post_shift = post_shift;
+    memset(state, 0, 4 * num_stages * sizeof(q31_t));
+}
+
+/**
+ * @brief Cascaded biquads. Each stage runs over the whole block with its
+ *        coefficients and state in registers, output of one stage is the
+ *        input of the next (in place in `out`).
+ */
+void dsp_biquad_q31(dsp_biquad_q31_t *bq, const q31_t *in, q31_t *out, uint32_t block)
+{
+    const q31_t *c = bq->coeffs;
+    q31_t *st = bq->state;
+    const uint32_t shift = 31 - bq->post_shift;
+    const q31_t *src = in;
+
+    for (uint32_t s = 0; s < bq->num_stages; ++s) {
+        const int32_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        int32_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+
+        for (uint32_t n = 0; n < block; ++n) {
+            int32_t x0 = src[n];
+            int64_t acc = (int64_t) b0 * x0;
+            acc += (int64_t) b1 * x1;
+            acc += (int64_t) b2 * x2;
+            acc += (int64_t) a1 * y1;
+            acc += (int64_t) a2 * y2;
+
+            int32_t y0 = sat_q31(acc >> shift);
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            out[n] = y0;
+        }
+
+        st[0] = x1;
+        st[1] = x2;
+        st[2] = y1;
+        st[3] = y2;
+        c += 5;
+        st += 4;
+        src = out;
+    }
+}
+
+/**
+ * @brief Reverse the base-4 digits of `i` (`digits` digits).
+ */
+static uint32_t digit_reverse4(uint32_t i, uint32_t digits)
+{
+    uint32_t r = 0;
+
+    while (digits--) {
+        r = (r << 2) | (i & 3);
+        i >>= 2;
+    }
+    return r;
+}
+
+/**
+ * @brief In-place complex radix-4 FFT (decimation in frequency).
+ *
+ * @param buf  n complex samples, interleaved { re, im }.
+ * @param n    power of 4, 4 .. DSP_FFT_MAX_N.
+ * @return 0 on success, -1 for an unsupported size.
+ *
+ * Every stage scales by 1/4 to avoid overflow, so the result is the DFT
+ * divided by n. Input samples must lie inside the unit circle.
+ */
+int dsp_cfft_q15(q15_t *buf, uint32_t n)
+{
+    uint32_t digits = 0;
+
+    if (n < 4 || n > DSP_FFT_MAX_N)
+        return -1;
+    for (uint32_t m = n; m > 1; m >>= 2) {
+        if (m & 3)
+            return -1;
+        digits++;
+    }
+
+    for (uint32_t n1 = n; n1 > 1; n1 >>= 2) {
+        const uint32_t n2 = n1 >> 2;
+        const uint32_t step = DSP_FFT_MAX_N / n1;
+
+        for (uint32_t j = 0; j < n2; ++j) {
+            const q15_t *w1 = &dsp_twiddle_q15[2 * (j * step)];
+            const q15_t *w2 = &dsp_twiddle_q15[2 * (2 * j * step)];
+            const q15_t *w3 = &dsp_twiddle_q15[2 * (3 * j * step)];
+            const int32_t c1 = w1[0], s1 = w1[1];
+            const int32_t c2 = w2[0], s2 = w2[1];
+            const int32_t c3 = w3[0], s3 = w3[1];
+
+            for (uint32_t i0 = j; i0 < n; i0 += n1) {
+                q15_t *p0 = &buf[2 * i0];
+                q15_t *p1 = p0 + 2 * n2;
+                q15_t *p2 = p1 + 2 * n2;
+                q15_t *p3 = p2 + 2 * n2;
+
+                int32_t ar = p0[0] >> 2, ai = p0[1] >> 2;
+                int32_t br = p1[0] >> 2, bi = p1[1] >> 2;
+                int32_t cr = p2[0] >> 2, ci = p2[1] >> 2;
+                int32_t dr = p3[0] >> 2, di = p3[1] >> 2;
+
+                int32_t t0r = ar + cr, t0i = ai + ci;
+                int32_t t1r = ar - cr, t1i = ai - ci;
+                int32_t t2r = br + dr, t2i = bi + di;
+                int32_t t3r = br - dr, t3i = bi - di;
+
+                // y0 = t0 + t2, y2 = t0 - t2, y1 = t1 - j t3, y3 = t1 + j t3
+                int32_t y1r = t1r + t3i, y1i = t1i - t3r;
+                int32_t y2r = t0r - t2r, y2i = t0i - t2i;
+                int32_t y3r = t1r - t3i, y3i = t1i + t3r;
+
+                p0[0] = t0r + t2r;
+                p0[1] = t0i + t2i;
+                // (x_r + j x_i)(c - j s)
+                p1[0] = (y1r * c1 + y1i * s1) >> 15;
+                p1[1] = (y1i * c1 - y1r * s1) >> 15;
+                p2[0] = (y2r * c2 + y2i * s2) >> 15;
+                p2[1] = (y2i * c2 - y2r * s2) >> 15;
+                p3[0] = (y3r * c3 + y3i * s3) >> 15;
+                p3[1] = (y3i * c3 - y3r * s3) >> 15;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t r = digit_reverse4(i, digits);
+        if (r > i) {
+            q15_t re = buf[2 * i], im = buf[2 * i + 1];
+            buf[2 * i] = buf[2 * r];
+            buf[2 * i + 1] = buf[2 * r + 1];
+            buf[2 * r] = re;
+            buf[2 * r + 1] = im;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief |z| of n complex Q15 samples.
+ */
+void dsp_cmplx_mag_q15(const q15_t *in, q15_t *out, uint32_t n)
+{
+    while (n--) {
+        int32_t re = in[0], im = in[1];
+        uint32_t mag = isqrt32((uint32_t) (re * re) + (uint32_t) (im * im));
+        *out++ = mag > INT16_MAX ? INT16_MAX : mag;
+        in += 2;
+    }
+}
+
+q15_t dsp_rms_q15(const q15_t *in, uint32_t n)
+{
+    uint64_t sum = 0;
+
+    if (n == 0)
+        return 0;
+    for (uint32_t i = 0; i < n; ++i)
+        sum += (int32_t) in[i] * in[i];
+
+    uint32_t rms = isqrt32((uint32_t) (sum / n));
+    return rms > INT16_MAX ? INT16_MAX : rms;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file   dsp.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Fixed-point (Q15 / Q31) DSP kernels for the Cortex-M3.
+ *
+ * The M3 has no FPU, so everything is integer. Products are accumulated
+ * in 64 bits, which GCC maps onto SMULL / SMLAL, and results saturate.
+ * All kernels work on blocks, so they can run directly on the halves of
+ * a circular ADC DMA buffer from the half / full transfer callbacks:
+ *
+ *     dsp_adc_to_q15(&adc_buf[half], x, BLOCK);
+ *     dsp_fir_q15(&fir, x, y, BLOCK);
+ *
+ * The FFT twiddle table is generated at build time for DSP_FFT_MAX_N
+ * points (make FFT_MAX_N=...) by tools/gen_dsp_tables.py.
+ */
+
+#ifndef __DSP_H
+#define __DSP_H
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+#ifndef DSP_FFT_MAX_N
+#define DSP_FFT_MAX_N   256
+#endif
+
+/**
+ * Twiddle factors W^k = cos(2 pi k / N) - j sin(2 pi k / N) for
+ * k = 0 .. 3N/4 - 1, stored as { cos, sin } pairs.
+ */
+extern const q15_t dsp_twiddle_q15[2 * DSP_FFT_MAX_N * 3 / 4];
+
+/**
+ * FIR filter. The state buffer holds num_taps - 1 + block samples, where
+ * block is the largest block size passed to dsp_fir_*().
+ * y[n] = sum(coeffs[i] * x[n - i]), coefficients in natural order.
+ */
+typedef struct
+{
+    uint32_t num_taps;
+    const q15_t *coeffs;
+    q15_t *state;
+} dsp_fir_q15_t;
+
+typedef struct
+{
+    uint32_t num_taps;
+    const q31_t *coeffs;
+    q31_t *state;
+} dsp_fir_q31_t;
+
+/**
+ * Cascaded biquads, direct form I. Per stage 5 coefficients
+ * { b0, b1, b2, a1, a2 } and 4 state words { x1, x2, y1, y2 }:
+ *
+ *   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2]
+ *
+ * (feedback coefficients with the sign already negated). Coefficients
+ * are Q31 scaled down by 2^post_shift, so post_shift = 1 allows
+ * coefficients in [-2, 2).
+ */
+typedef struct
+{
+    uint32_t num_stages;
+    const q31_t *coeffs;
+    q31_t *state;
+    uint32_t post_shift;
+} dsp_biquad_q31_t;
+
+void dsp_adc_to_q15(const uint16_t *adc, q15_t *out, uint32_t n);
+
+void dsp_fir_q15_init(dsp_fir_q15_t *fir, uint32_t num_taps,
+                      const q15_t *coeffs, q15_t *state);
+void dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t block);
+
+void dsp_fir_q31_init(dsp_fir_q31_t *fir, uint32_t num_taps,
+                      const q31_t *coeffs, q31_t *state);
+void dsp_fir_q31(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t block);
+
+void dsp_biquad_q31_init(dsp_biquad_q31_t *bq, uint32_t num_stages,
+                         const q31_t *coeffs, q31_t *state, uint32_t post_shift);
+void dsp_biquad_q31(dsp_biquad_q31_t *bq, const q31_t *in, q31_t *out, uint32_t block);
+
+int  dsp_cfft_q15(q15_t *buf, uint32_t n);
+void dsp_cmplx_mag_q15(const q15_t *in, q15_t *out, uint32_t n);
+q15_t dsp_rms_q15(const q15_t *in, uint32_t n);
+
+#endif /* __DSP_H */
@@ -0,0 +1,427 @@
+/**
+ * @file   eth.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Ethernet MAC and DMA driver.
+ *
+ * Both descriptor lists are rings. Each descriptor is followed by two
+ * words the DMA skips (DMABMR.DSL): the buffer address, which the
+ * timestamp write-back overwrites in DES2, and a spare.
+ */
+
+#include "stm32f107xc.h"
+#include "eth.h"
+
+// RCC_APB2ENR, RCC_AHBENR, RCC_AHBRSTR
+#define AFIOEN              0
+#define IOPAEN              2
+#define IOPBEN              3
+#define IOPCEN              4
+#define ETHMACEN            14
+#define ETHMACTXEN          15
+#define ETHMACRXEN          16
+#define ETHMACRST           14
+
+// AFIO_MAPR
+#define MII_RMII_SEL        (1UL << 23)
+
+// ETH_MACCR
+#define MACCR_RE            (1 << 2)
+#define MACCR_TE            (1 << 3)
+#define MACCR_IPCO          (1 << 10)
+#define MACCR_DM            (1 << 11)
+#define MACCR_LM            (1 << 12)
+#define MACCR_FES           (1 << 14)
+
+// ETH_MACFFR
+#define MACFFR_PAM          (1 << 4)
+
+// ETH_MACMIIAR
+#define MACMIIAR_MB         (1 << 0)
+#define MACMIIAR_MW         (1 << 1)
+#define MACMIIAR_CR_42      (0 << 2)        /* HCLK 60-72 MHz */
+#define MACMIIAR_CR_16      (2 << 2)        /* HCLK 20-35 MHz */
+#define MACMIIAR_CR_26      (3 << 2)        /* HCLK 35-60 MHz */
+
+// ETH_DMABMR
+#define DMABMR_SR           (1 << 0)
+#define DMABMR_DSL(words)   ((words) << 2)
+#define DMABMR_PBL(beats)   ((beats) << 8)
+#define DMABMR_FB           (1 << 16)
+#define DMABMR_AAB          (1UL << 25)
+
+// ETH_DMASR
+#define DMASR_TBUS          (1 << 2)
+#define DMASR_RBUS          (1 << 7)
+
+// ETH_DMAOMR
+#define DMAOMR_SR           (1 << 1)
+#define DMAOMR_ST           (1 << 13)
+#define DMAOMR_TSF          (1UL << 21)
+#define DMAOMR_RSF          (1UL << 25)
+
+// TDES0
+#define TDES0_OWN           (1UL << 31)
+#define TDES0_LS            (1UL << 29)
+#define TDES0_FS            (1UL << 28)
+#define TDES0_TTSE          (1UL << 25)
+#define TDES0_CIC_FULL      (3UL << 22)
+#define TDES0_TER           (1UL << 21)
+#define TDES0_TTSS          (1UL << 17)
+
+// RDES0, RDES1
+#define RDES0_OWN           (1UL << 31)
+#define RDES0_FL(des0)      (((des0) >> 16) & 0x3FFF)
+#define RDES0_DE            (1 << 14)
+#define RDES0_OE            (1 << 11)
+#define RDES0_FS            (1 << 9)
+#define RDES0_LS            (1 << 8)
+#define RDES0_LCO           (1 << 6)
+#define RDES0_RWT           (1 << 4)
+#define RDES0_RE            (1 << 3)
+#define RDES0_CE            (1 << 1)
+#define RDES0_ERRORS        (RDES0_DE | RDES0_OE | RDES0_LCO | RDES0_RWT | RDES0_RE | RDES0_CE)
+#define RDES1_RER           (1 << 15)
+
+// PHY registers, IEEE 802.3 clause 22
+#define PHY_BMCR            0
+#define PHY_BMSR            1
+#define PHY_ANAR            4
+#define PHY_ANLPAR          5
+#define BMCR_RESTART_AN     (1 << 9)
+#define BMCR_AN_ENABLE      (1 << 12)
+#define BMCR_RESET          (1 << 15)
+#define BMSR_LINK           (1 << 2)
+#define BMSR_AN_DONE        (1 << 5)
+#define ANAR_10HD           (1 << 5)
+#define ANAR_10FD           (1 << 6)
+#define ANAR_100HD          (1 << 7)
+#define ANAR_100FD          (1 << 8)
+
+// GPIO CNF/MODE nibbles
+#define PIN_INPUT           0x4             /* floating input */
+#define PIN_AF_50MHZ        0xB             /* alternate function push-pull */
+
+#define ETH_TIMEOUT         0x100000
+#define PHY_RESET_READS     20000           /* over 0.5 s of MDIO reads */
+#define FCS_LEN             4
+
+typedef struct
+{
+    volatile uint32_t des0;
+    volatile uint32_t des1;
+    volatile uint32_t des2;                 /* buffer, or timestamp subseconds */
+    volatile uint32_t des3;                 /* timestamp seconds */
+    uint32_t buf;                           /* DES2 as programmed */
+    uint32_t spare;
+} eth_desc_t;
+
+#define DESC_SKIP_WORDS     2
+
+static eth_desc_t rx_desc[ETH_RX_BUFS];
+static eth_desc_t tx_desc[ETH_TX_BUFS];
+static uint32_t rx_buf[ETH_RX_BUFS][ETH_BUF_SIZE / 4];
+static uint32_t tx_buf[ETH_TX_BUFS][ETH_BUF_SIZE / 4];
+static uint32_t rx_next;
+static uint32_t tx_next;
+static uint32_t mii_clock;
+static eth_stats_t stats;
+
+/**
+ * @brief Wait for the MAC to clear `mask` in `reg`. The QEMU register
+ *        image has no MAC behind it and completes at once.
+ */
+static int eth_wait(volatile uint32_t *reg, uint32_t mask)
+{
+#ifdef BOARD_QEMU
+    *reg &= ~mask;
+    return ETH_OK;
+#else
+    for (uint32_t i = 0; i < ETH_TIMEOUT; ++i)
+        if (!(*reg & mask))
+            return ETH_OK;
+    return ETH_ERROR;
+#endif
+}
+
+static void pin_mode(GPIO_TypeDef *port, uint32_t pin, uint32_t mode)
+{
+    volatile uint32_t *cr = pin < 8 ? &port->CRL : &port->CRH;
+    uint32_t shift = (pin & 7) * 4;
+
+    *cr = (*cr & ~(0xFUL << shift)) | (mode << shift);
+}
+
+/**
+ * @brief RMII, no remap: REF_CLK PA1, MDIO PA2, CRS_DV PA7, MDC PC1,
+ *        RXD0/1 PC4/PC5, TX_EN PB11, TXD0/1 PB12/PB13.
+ */
+static void eth_pins(void)
+{
+    RCC->APB2ENR |= (1 << AFIOEN) | (1 << IOPAEN) | (1 << IOPBEN) | (1 << IOPCEN);
+
+    pin_mode(PORTA, 1, PIN_INPUT);
+    pin_mode(PORTA, 2, PIN_AF_50MHZ);
+    pin_mode(PORTA, 7, PIN_INPUT);
+    pin_mode(PORTB, 11, PIN_AF_50MHZ);
+    pin_mode(PORTB, 12, PIN_AF_50MHZ);
+    pin_mode(PORTB, 13, PIN_AF_50MHZ);
+    pin_mode(PORTC, 1, PIN_AF_50MHZ);
+    pin_mode(PORTC, 4, PIN_INPUT);
+    pin_mode(PORTC, 5, PIN_INPUT);
+}
+
+uint16_t eth_phy_read(uint32_t reg)
+{
+    ETHERNET->MACMIIAR = (ETH_PHY_ADDR << 11) | (reg << 6) | mii_clock | MACMIIAR_MB;
+    eth_wait(&ETHERNET->MACMIIAR, MACMIIAR_MB);
+    return ETHERNET->MACMIIDR;
+}
+
+void eth_phy_write(uint32_t reg, uint16_t value)
+{
+    ETHERNET->MACMIIDR = value;
+    ETHERNET->MACMIIAR = (ETH_PHY_ADDR << 11) | (reg << 6) | mii_clock |
+                         MACMIIAR_MW | MACMIIAR_MB;
+    eth_wait(&ETHERNET->MACMIIAR, MACMIIAR_MB);
+}
+
+static void rx_give_back(eth_desc_t *d, uint32_t i)
+{
+    d->des2 = d->buf;
+    d->des1 = (i == ETH_RX_BUFS - 1 ? RDES1_RER : 0) | ETH_BUF_SIZE;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    d->des0 = RDES0_OWN;
+}
+
+static void eth_rings(void)
+{
+    for (uint32_t i = 0; i < ETH_RX_BUFS; ++i) {
+        rx_desc[i].buf = (uint32_t) rx_buf[i];
+        rx_desc[i].des3 = 0;
+        rx_give_back(&rx_desc[i], i);
+    }
+    for (uint32_t i = 0; i < ETH_TX_BUFS; ++i) {
+        tx_desc[i].buf = (uint32_t) tx_buf[i];
+        tx_desc[i].des0 = i == ETH_TX_BUFS - 1 ? TDES0_TER : 0;
+        tx_desc[i].des2 = tx_desc[i].buf;
+        tx_desc[i].des3 = 0;
+    }
+    rx_next = 0;
+    tx_next = 0;
+
+    ETHERNET->DMARDLAR = (uint32_t) rx_desc;
+    ETHERNET->DMATDLAR = (uint32_t) tx_desc;
+}
+
+/**
+ * @brief Reset the MAC, start the PHY auto-negotiation and both DMA
+ *        directions. The link comes up later, see eth_link().
+ * @return ETH_ERROR if the MAC does not leave reset, no RMII clock.
+ */
+int eth_init(const uint8_t mac[6], uint32_t hclk_hz)
+{
+    // the interface is selected while the MAC is held in reset
+    RCC->AHBRSTR |= (1 << ETHMACRST);
+    eth_pins();
+    AFIO->MAPR |= MII_RMII_SEL;
+    RCC->AHBENR |= (1 << ETHMACEN) | (1 << ETHMACTXEN) | (1 << ETHMACRXEN);
+    RCC->AHBRSTR &= ~(1 << ETHMACRST);
+
+    ETHERNET->DMABMR |= DMABMR_SR;
+    if (eth_wait(&ETHERNET->DMABMR, DMABMR_SR) != ETH_OK)
+        return ETH_ERROR;
+
+    if (hclk_hz >= 60000000)
+        mii_clock = MACMIIAR_CR_42;
+    else if (hclk_hz >= 35000000)
+        mii_clock = MACMIIAR_CR_26;
+    else
+        mii_clock = MACMIIAR_CR_16;
+
+    eth_phy_write(PHY_BMCR, BMCR_RESET);
+    for (uint32_t i = 0; i < PHY_RESET_READS && (eth_phy_read(PHY_BMCR) & BMCR_RESET); ++i)
+        ;
+    eth_phy_write(PHY_ANAR, ANAR_100FD | ANAR_100HD | ANAR_10FD | ANAR_10HD | 1);
+    eth_phy_write(PHY_BMCR, BMCR_AN_ENABLE | BMCR_RESTART_AN);
+
+    ETHERNET->MACA0HR = mac[4] | (mac[5] << 8);
+    ETHERNET->MACA0LR = mac[0] | (mac[1] << 8) | (mac[2] << 16) | ((uint32_t) mac[3] << 24);
+    ETHERNET->MACFFR = MACFFR_PAM;
+    ETHERNET->MACCR = MACCR_IPCO | MACCR_FES | MACCR_DM;
+
+    eth_rings();
+    ETHERNET->DMABMR = DMABMR_AAB | DMABMR_FB | DMABMR_PBL(32) | DMABMR_DSL(DESC_SKIP_WORDS);
+    // store and forward, required by the checksum offload
+    ETHERNET->DMAOMR = DMAOMR_RSF | DMAOMR_TSF;
+    ETHERNET->MACCR |= MACCR_TE | MACCR_RE;
+    ETHERNET->DMAOMR |= DMAOMR_ST | DMAOMR_SR;
+
+    stats = (eth_stats_t) { 0 };
+    return ETH_OK;
+}
+
+/**
+ * @brief Read the PHY and set the MAC to the negotiated speed and duplex.
+ *        Call it from time to time, the PHY is not watched otherwise.
+ * @return ETH_LINK_* flags, 0 while the link is down.
+ */
+int eth_link(void)
+{
+    // the link bit latches low, the second read is current
+    eth_phy_read(PHY_BMSR);
+    uint16_t bmsr = eth_phy_read(PHY_BMSR);
+    if (!(bmsr & BMSR_LINK) || !(bmsr & BMSR_AN_DONE))
+        return 0;
+
+    uint16_t common = eth_phy_read(PHY_ANAR) & eth_phy_read(PHY_ANLPAR);
+    uint32_t maccr = ETHERNET->MACCR & ~(MACCR_FES | MACCR_DM);
+    int link = ETH_LINK_UP;
+
+    if (common & (ANAR_100FD | ANAR_100HD)) {
+        link |= ETH_LINK_100M;
+        maccr |= MACCR_FES;
+        if (common & ANAR_100FD)
+            link |= ETH_LINK_FULL;
+    } else if (common & ANAR_10FD) {
+        link |= ETH_LINK_FULL;
+    }
+    if (link & ETH_LINK_FULL)
+        maccr |= MACCR_DM;
+    if (ETHERNET->MACCR != maccr)
+        ETHERNET->MACCR = maccr;
+    return link;
+}
+
+/**
+ * @brief Internal MAC loopback: transmitted frames come back to the
+ *        receiver instead of going to the PHY, for self tests.
+ */
+void eth_loopback(int enable)
+{
+    if (enable)
+        ETHERNET->MACCR |= MACCR_LM;
+    else
+        ETHERNET->MACCR &= ~MACCR_LM;
+}
+
+/**
+ * @brief The buffer to build the next frame in, destination MAC first.
+ * @return NULL while the DMA still owns it.
+ */
+uint8_t *eth_tx_alloc(void)
+{
+    eth_desc_t *d = &tx_desc[tx_next];
+
+    if (d->des0 & TDES0_OWN) {
+        stats.tx_busy++;
+        return 0;
+    }
+    return (uint8_t *) d->buf;
+}
+
+/**
+ * @brief Hand the frame built in the eth_tx_alloc() buffer to the DMA.
+ *        Short frames are padded by the MAC.
+ * @return handle for eth_tx_timestamp().
+ */
+int eth_tx_send(uint32_t len, uint32_t flags)
+{
+    int handle = tx_next;
+    eth_desc_t *d = &tx_desc[handle];
+    uint32_t des0 = TDES0_FS | TDES0_LS;
+
+    if (handle == ETH_TX_BUFS - 1)
+        des0 |= TDES0_TER;
+    if (flags & ETH_TX_TIMESTAMP)
+        des0 |= TDES0_TTSE;
+    if (flags & ETH_TX_CSUM)
+        des0 |= TDES0_CIC_FULL;
+
+    d->des2 = d->buf;
+    d->des1 = len;
+    d->des0 = des0;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    d->des0 = des0 | TDES0_OWN;
+
+    tx_next = (tx_next + 1) % ETH_TX_BUFS;
+    ETHERNET->DMASR = DMASR_TBUS;
+    ETHERNET->DMATPDR = 0;
+    stats.tx++;
+    return handle;
+}
+
+/**
+ * @brief Transmit timestamp of a frame sent with ETH_TX_TIMESTAMP, valid
+ *        until its buffer is handed out again.
+ * @return 1 with `ts` set, 0 while it is being sent, ETH_ERROR if none.
+ */
+int eth_tx_timestamp(int handle, eth_ts_t *ts)
+{
+    eth_desc_t *d = &tx_desc[handle];
+    uint32_t des0 = d->des0;
+
+    if (des0 & TDES0_OWN)
+        return 0;
+    if (!(des0 & TDES0_TTSS))
+        return ETH_ERROR;
+    ts->subsec = d->des2;
+    ts->sec = d->des3;
+    return 1;
+}
+
+/**
+ * @brief Take the next received frame, in place. One frame at a time,
+ *        release it before asking for the next one.
+ * @return 1 with `frame` set, 0 if there is none.
+ */
+int eth_rx(eth_frame_t *frame)
+{
+    while (1) {
+        eth_desc_t *d = &rx_desc[rx_next];
+        uint32_t des0 = d->des0;
+
+        if (des0 & RDES0_OWN) {
+            if (ETHERNET->DMASR & DMASR_RBUS) {
+                // the DMA ran out of buffers and suspended
+                stats.rx_stalls++;
+                ETHERNET->DMASR = DMASR_RBUS;
+                ETHERNET->DMARPDR = 0;
+            }
+            return 0;
+        }
+
+        uint32_t len = RDES0_FL(des0);
+        if ((des0 & (RDES0_FS | RDES0_LS)) == (RDES0_FS | RDES0_LS) &&
+            !(des0 & RDES0_ERRORS) && len > FCS_LEN && len <= ETH_BUF_SIZE) {
+            frame->data = (uint8_t *) d->buf;
+            frame->len = len - FCS_LEN;
+            frame->status = des0;
+            frame->ts.subsec = d->des2;
+            frame->ts.sec = d->des3;
+            stats.rx++;
+            return 1;
+        }
+
+        stats.rx_errors++;
+        rx_give_back(d, rx_next);
+        rx_next = (rx_next + 1) % ETH_RX_BUFS;
+    }
+}
+
+void eth_rx_release(eth_frame_t *frame)
+{
+    (void) frame;
+
+    rx_give_back(&rx_desc[rx_next], rx_next);
+    rx_next = (rx_next + 1) % ETH_RX_BUFS;
+    if (ETHERNET->DMASR & DMASR_RBUS) {
+        ETHERNET->DMASR = DMASR_RBUS;
+        ETHERNET->DMARPDR = 0;
+    }
+}
+
+void eth_stats(eth_stats_t *s)
+{
+    *s = stats;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file   eth.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Ethernet MAC and DMA driver, RMII PHY on the default pins.
+ *
+ * Frames stay in the DMA buffers: eth_rx() hands out the buffer the
+ * frame was received into and eth_tx_alloc() the one the next frame is
+ * built in. Only called from the main loop.
+ *
+ * The PTP unit timestamps every received frame and every transmitted
+ * frame sent with ETH_TX_TIMESTAMP. The DMA writes the timestamp over
+ * the buffer address in the descriptor, the driver keeps its own copy.
+ *
+ * The caller sets up the clock tree first, HCLK at least 25 MHz for
+ * 100 Mbit/s. The PHY provides the 50 MHz RMII reference clock.
+ */
+
+#ifndef __ETH_H
+#define __ETH_H
+
+#include <stdint.h>
+
+#ifndef ETH_RX_BUFS
+#define ETH_RX_BUFS         4
+#endif
+#ifndef ETH_TX_BUFS
+#define ETH_TX_BUFS         4
+#endif
+#ifndef ETH_PHY_ADDR
+#define ETH_PHY_ADDR        1
+#endif
+
+#define ETH_HDR_LEN         14
+#define ETH_MTU             1500
+#define ETH_BUF_SIZE        1524            /* frame with FCS, multiple of 4 */
+
+#define ETH_OK              0
+#define ETH_ERROR           (-1)
+
+// eth_link()
+#define ETH_LINK_UP         (1 << 0)
+#define ETH_LINK_100M       (1 << 1)
+#define ETH_LINK_FULL       (1 << 2)
+
+// eth_tx_send() flags
+#define ETH_TX_TIMESTAMP    (1 << 0)
+#define ETH_TX_CSUM         (1 << 1)        /* fill in IPv4 and UDP/TCP/ICMP checksums */
+
+/* Checksum offload result in eth_frame_t.status (RDES0 bits 5, 7, 0):
+ * an IPv4 frame whose header or payload checksum is wrong. */
+#define ETH_RX_FT           (1 << 5)
+#define ETH_RX_IPHCE        (1 << 7)
+#define ETH_RX_PCE          (1 << 0)
+#define ETH_RX_CSUM_ERROR(status) \
+    (((status) & ETH_RX_FT) && ((status) & (ETH_RX_IPHCE | ETH_RX_PCE)))
+
+/* PTP system time: seconds and binary subseconds, 2^-31 s. */
+typedef struct
+{
+    uint32_t sec;
+    uint32_t subsec;
+} eth_ts_t;
+
+typedef struct
+{
+    uint8_t *data;              /* destination MAC first */
+    uint32_t len;               /* without FCS */
+    uint32_t status;            /* RDES0 */
+    eth_ts_t ts;                /* start of frame */
+} eth_frame_t;
+
+typedef struct
+{
+    uint32_t rx;
+    uint32_t rx_errors;         /* bad or oversized frames */
+    uint32_t rx_stalls;         /* no free buffer, frames lost */
+    uint32_t tx;
+    uint32_t tx_busy;           /* eth_tx_alloc() found no buffer */
+} eth_stats_t;
+
+int  eth_init(const uint8_t mac[6], uint32_t hclk_hz);
+int  eth_link(void);
+uint16_t eth_phy_read(uint32_t reg);
+void eth_phy_write(uint32_t reg, uint16_t value);
+void eth_loopback(int enable);
+
+uint8_t *eth_tx_alloc(void);
+int  eth_tx_send(uint32_t len, uint32_t flags);
+int  eth_tx_timestamp(int handle, eth_ts_t *ts);
+
+int  eth_rx(eth_frame_t *frame);
+void eth_rx_release(eth_frame_t *frame);
+
+void eth_stats(eth_stats_t *stats);
+
+#endif /* __ETH_H */
@@ -0,0 +1,140 @@
+/**
+ * @file   flash.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Embedded flash programming driver.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "stm32f107xc.h"
+#include "compiler.h"
+#include "flash.h"
+
+#ifndef BOARD_QEMU
+void flash_unlock(void)
+{
+    if (FLASH_IT->CR & FLASH_CR_LOCK) {
+        FLASH_IT->KEYR = FLASH_KEY1;
+        FLASH_IT->KEYR = FLASH_KEY2;
+    }
+}
+
+void flash_lock(void)
+{
+    FLASH_IT->CR |= FLASH_CR_LOCK;
+}
+
+/**
+ * @brief Result of the last operation, clears the status flags once it
+ *        is done.
+ * @return FLASH_BUSY, FLASH_OK or FLASH_ERROR.
+ */
+__RAMFUNC int flash_status(void)
+{
+    uint32_t sr = FLASH_IT->SR;
+
+    if (sr & FLASH_SR_BSY)
+        return FLASH_BUSY;
+
+    FLASH_IT->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
+    FLASH_IT->CR &= ~(FLASH_CR_PG | FLASH_CR_PER);
+    return (sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) ? FLASH_ERROR : FLASH_OK;
+}
+
+__RAMFUNC void flash_start_erase(uint32_t addr)
+{
+    FLASH_IT->CR = (FLASH_IT->CR & ~FLASH_CR_PG) | FLASH_CR_PER;
+    FLASH_IT->AR = addr;
+    FLASH_IT->CR |= FLASH_CR_STRT;
+}
+
+__RAMFUNC void flash_start_program(uint32_t addr, uint16_t half_word)
+{
+    FLASH_IT->CR = (FLASH_IT->CR & ~FLASH_CR_PER) | FLASH_CR_PG;
+    *(volatile uint16_t *) addr = half_word;
+}
+
+#else
+/*
+ * QEMU has no flash controller, the storage is RAM (board_qemu.h).
+ * Operations finish at once, programming only clears bits like on flash.
+ * FLASH_IT is a register image: a test sets PGERR or WRPRTERR in SR to
+ * fail the next operation. The end of an operation pends FLASH_IRQn
+ * when the controller would raise it.
+ */
+void flash_unlock(void)
+{
+}
+
+void flash_lock(void)
+{
+}
+
+int flash_status(void)
+{
+    uint32_t sr = FLASH_IT->SR;
+
+    FLASH_IT->SR = 0;
+    return (sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) ? FLASH_ERROR : FLASH_OK;
+}
+
+static void flash_done(void)
+{
+    uint32_t ie = (FLASH_IT->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR))
+                ? FLASH_CR_ERRIE : FLASH_CR_EOPIE;
+
+    if (FLASH_IT->CR & ie)
+        NVIC_ISPR0 = (1 << FLASH_IRQn);
+}
+
+void flash_start_erase(uint32_t addr)
+{
+    memset((void *) (addr & ~(FLASH_PAGE_SIZE - 1)), 0xFF, FLASH_PAGE_SIZE);
+    flash_done();
+}
+
+void flash_start_program(uint32_t addr, uint16_t half_word)
+{
+    *(volatile uint16_t *) addr &= half_word;
+    flash_done();
+}
+#endif
+
+static __RAMFUNC int flash_wait(void)
+{
+    int status;
+
+    while ((status = flash_status()) == FLASH_BUSY)
+        ;
+    return status;
+}
+
+/**
+ * @brief Erase the page containing `addr`, blocking.
+ */
+__RAMFUNC int flash_erase_page(uint32_t addr)
+{
+    flash_start_erase(addr);
+    return flash_wait();
+}
+
+/**
+ * @brief Program `len` bytes at `addr` (half-word aligned), blocking.
+ *        An odd trailing byte is padded with 0xFF.
+ */
+__RAMFUNC int flash_program(uint32_t addr, const void *data, uint32_t len)
+{
+    const uint8_t *p = data;
+
+    for (uint32_t i = 0; i < len; i += 2) {
+        uint16_t half_word = p[i] | ((i + 1 < len ? p[i + 1] : 0xFF) << 8);
+
+        flash_start_program(addr + i, half_word);
+        if (flash_wait() != FLASH_OK)
+            return FLASH_ERROR;
+        if (*(volatile uint16_t *) (addr + i) != half_word)
+            return FLASH_ERROR;
+    }
+    return FLASH_OK;
+}
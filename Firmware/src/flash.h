@@ -0,0 +1,57 @@
+/**
+ * @file   flash.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Embedded flash programming driver.
+ *
+ * Flash is programmed a half-word at a time and erased a 2 KB page at a
+ * time. Code fetched from flash stalls while an operation is running,
+ * so everything that touches the controller lives in SRAM (__RAMFUNC).
+ * The flash_start_*() calls only start an operation, flash_status()
+ * tells when it is done, so the CPU can keep working from SRAM.
+ */
+
+#ifndef __FLASH_H
+#define __FLASH_H
+
+#include <stdint.h>
+
+#define FLASH_PAGE_SIZE     2048
+#define FLASH_SIZE          (256 * 1024)
+#define FLASH_IRQn          4
+
+// FLASH_KEYR
+#define FLASH_KEY1          0x45670123
+#define FLASH_KEY2          0xCDEF89AB
+
+// FLASH_SR
+#define FLASH_SR_BSY        (1 << 0)
+#define FLASH_SR_PGERR      (1 << 2)
+#define FLASH_SR_WRPRTERR   (1 << 4)
+#define FLASH_SR_EOP        (1 << 5)
+
+// FLASH_CR
+#define FLASH_CR_PG         (1 << 0)
+#define FLASH_CR_PER        (1 << 1)
+#define FLASH_CR_MER        (1 << 2)
+#define FLASH_CR_STRT       (1 << 6)
+#define FLASH_CR_LOCK       (1 << 7)
+#define FLASH_CR_ERRIE      (1 << 10)
+#define FLASH_CR_EOPIE      (1 << 12)
+
+// flash_status()
+#define FLASH_BUSY          1
+#define FLASH_OK            0
+#define FLASH_ERROR         (-1)
+
+void flash_unlock(void);
+void flash_lock(void);
+
+int  flash_erase_page(uint32_t addr);
+int  flash_program(uint32_t addr, const void *data, uint32_t len);
+
+void flash_start_erase(uint32_t addr);
+void flash_start_program(uint32_t addr, uint16_t half_word);
+int  flash_status(void);
+
+#endif /* __FLASH_H */
@@ -0,0 +1,237 @@
+/**
+ * @file   fwupdate.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Firmware update into the inactive A/B slot.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "stm32f107xc.h"
+#include "compiler.h"
+#include "crc.h"
+#include "flash.h"
+#include "image.h"
+#include "fwupdate.h"
+
+typedef struct
+{
+    uint32_t addr;
+    uint32_t len;
+    uint32_t pos;
+    uint8_t  data[FWUPDATE_CHUNK_SIZE];
+} chunk_t;
+
+/*
+ * chunks[head] is programmed by the engine (interrupt), chunks[fill] is
+ * filled by the caller. The engine clears len of a finished chunk.
+ */
+static chunk_t chunks[2];
+static uint32_t fill;
+static volatile uint32_t head;
+static volatile uint32_t queued;
+static volatile uint32_t busy;
+static volatile int error;
+
+static uint32_t slot;
+static uint32_t erased_end;
+static uint32_t received;
+static image_header_t header;
+
+static inline void irq_disable(void)
+{
+    __asm__ volatile ("cpsid i" : : : "memory");
+}
+
+static inline void irq_enable(void)
+{
+    __asm__ volatile ("cpsie i" : : : "memory");
+}
+
+/**
+ * @brief Start the next erase or half-word program. Flash must be idle.
+ *        After an error the queued chunks are dropped, so nothing waits
+ *        for them.
+ */
+static __RAMFUNC void engine_step(void)
+{
+    if (error)
+        queued = 0;
+
+    while (queued) {
+        chunk_t *c = &chunks[head];
+
+        if (c->pos >= c->len) {
+            c->len = 0;
+            head ^= 1;
+            queued--;
+            continue;
+        }
+
+        uint32_t addr = c->addr + c->pos;
+        if (addr >= erased_end) {
+            flash_start_erase(erased_end);
+            erased_end += FLASH_PAGE_SIZE;
+        } else {
+            flash_start_program(addr, c->data[c->pos] | (c->data[c->pos + 1] << 8));
+            c->pos += 2;
+        }
+        busy = 1;
+        return;
+    }
+    busy = 0;
+}
+
+/**
+ * @brief End of erase / program: check the result, start the next one.
+ */
+__RAMFUNC void FLASH_Handler(void)
+{
+    int status = flash_status();
+
+    if (status == FLASH_BUSY)
+        return;
+    if (status == FLASH_ERROR)
+        error = 1;
+    engine_step();
+}
+
+/**
+ * @brief Hand the fill buffer to the programming engine.
+ */
+static __RAMFUNC void queue_chunk(void)
+{
+    chunk_t *c = &chunks[fill];
+
+    // the engine programs half-words
+    if (c->len & 1)
+        c->data[c->len++] = 0xFF;
+
+    fill ^= 1;
+    irq_disable();
+    queued++;
+    if (!busy)
+        engine_step();
+    irq_enable();
+}
+
+int fwupdate_begin(void)
+{
+    uint32_t running = IMAGE_RUNNING();
+
+    if (running == SLOT_A_BASE)
+        slot = SLOT_B_BASE;
+    else if (running == SLOT_B_BASE)
+        slot = SLOT_A_BASE;
+    else
+        return FWUPDATE_ERR_SLOT;
+
+    crc_init();
+    fill = head = queued = busy = 0;
+    error = 0;
+    erased_end = slot;
+    received = 0;
+    memset(&header, 0xFF, sizeof(header));
+    chunks[0].len = chunks[1].len = 0;
+
+    flash_unlock();
+    FLASH_IT->CR |= FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+    NVIC_ISER0 = (1 << FLASH_IRQn);
+    return FWUPDATE_OK;
+}
+
+/**
+ * @brief Append image data. The header is kept in SRAM and programmed
+ *        by fwupdate_finish(), everything else goes to the slot.
+ * @note  Copies with its own loop, memcpy() is in flash.
+ */
+__RAMFUNC __attribute__((optimize("no-tree-loop-distribute-patterns")))
+int fwupdate_write(const void *data, uint32_t len)
+{
+    const uint8_t *p = data;
+
+    while (len) {
+        if (error)
+            return FWUPDATE_ERR_FLASH;
+
+        if (received < IMAGE_HEADER_SIZE) {
+            uint32_t n = IMAGE_HEADER_SIZE - received;
+            if (n > len)
+                n = len;
+            for (uint32_t i = 0; i < n; ++i)
+                if (received + i < sizeof(header))
+                    ((uint8_t *) &header)[received + i] = p[i];
+            received += n;
+            p += n;
+            len -= n;
+            continue;
+        }
+
+        if (received + len > SLOT_SIZE)
+            return FWUPDATE_ERR_SIZE;
+
+        // both buffers in flight: wait for the engine
+        while (queued == 2)
+            ;
+
+        chunk_t *c = &chunks[fill];
+        if (c->len == 0) {
+            c->addr = slot + received;
+            c->pos = 0;
+        }
+
+        uint32_t n = FWUPDATE_CHUNK_SIZE - c->len;
+        if (n > len)
+            n = len;
+        for (uint32_t i = 0; i < n; ++i)
+            c->data[c->len + i] = p[i];
+        c->len += n;
+        received += n;
+        p += n;
+        len -= n;
+
+        if (c->len == FWUPDATE_CHUNK_SIZE)
+            queue_chunk();
+    }
+    return FWUPDATE_OK;
+}
+
+/**
+ * @brief Flush, verify the written image against its header and commit
+ *        it by programming the header with the next sequence number.
+ */
+int fwupdate_finish(void)
+{
+    int result = FWUPDATE_OK;
+
+    while (queued == 2)
+        ;
+    if (chunks[fill].len)
+        queue_chunk();
+    while (queued || busy)
+        ;
+
+    NVIC_ICER0 = (1 << FLASH_IRQn);
+    FLASH_IT->CR &= ~(FLASH_CR_EOPIE | FLASH_CR_ERRIE);
+
+    if (error) {
+        result = FWUPDATE_ERR_FLASH;
+    } else if (header.magic != IMAGE_MAGIC
+               || header.size != received - IMAGE_HEADER_SIZE
+               || header.size % 4
+               || crc32_hw((const uint32_t *) IMAGE_VECTORS(slot), header.size / 4) != header.crc) {
+        result = FWUPDATE_ERR_IMAGE;
+    } else {
+        const image_header_t *running = IMAGE_HEADER(IMAGE_RUNNING());
+
+        header.seq = running->seq + 1;
+        header.hdr_crc = image_header_crc(&header);
+        if (flash_program(slot, &header, sizeof(header)) != FLASH_OK)
+            result = FWUPDATE_ERR_FLASH;
+        else if (!image_valid(slot))
+            result = FWUPDATE_ERR_IMAGE;
+    }
+
+    flash_lock();
+    return result;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file   fwupdate.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Firmware update into the inactive A/B slot.
+ *
+ * Feed the .img produced by tools/mkimage.py in pieces of any size:
+ *
+ *     fwupdate_begin();
+ *     while (receiving)
+ *         fwupdate_write(buf, len);
+ *     fwupdate_finish();          // then reset into the bootloader
+ *
+ * Pages are erased just ahead of the data and programming is driven by
+ * the flash end-of-operation interrupt, from SRAM, while the caller
+ * receives the next chunk into the other buffer. fwupdate_write() only
+ * waits when both buffers are still being programmed. Transport code
+ * running during an update should be __RAMFUNC as well, code in flash
+ * stalls for as long as the controller is busy.
+ */
+
+#ifndef __FWUPDATE_H
+#define __FWUPDATE_H
+
+#include <stdint.h>
+
+#define FWUPDATE_CHUNK_SIZE     256
+
+// return values
+#define FWUPDATE_OK             0
+#define FWUPDATE_ERR_SLOT       (-1)    /* not running from a slot */
+#define FWUPDATE_ERR_SIZE       (-2)    /* image does not fit the slot */
+#define FWUPDATE_ERR_FLASH      (-3)    /* erase / program failed */
+#define FWUPDATE_ERR_IMAGE      (-4)    /* bad header or CRC */
+
+int fwupdate_begin(void);
+int fwupdate_write(const void *data, uint32_t len);
+int fwupdate_finish(void);
+
+#endif /* __FWUPDATE_H */
@@ -0,0 +1,41 @@
+/**
+ * @file   gpio.cpp
+ * @author cy023
+ * @date   2021.06.02
+ * @brief  gpio implementation, on the register types of stm32f107xc.hpp.
+ */
+
+#include "stm32f107xc.hpp"
+
+extern "C" {
+#include "gpio.h"
+}
+
+using namespace stm32;
+
+void delay_(void)
+{
+    for (int i = 0; i < 800000; ++i)
+        ;
+}
+
+/* PC13 push-pull output, 2 MHz. CRH is modified in one load and one
+ * store, and the reset CNF13 bits (floating input) are cleared. */
+void gpio_init(void)
+{
+    rcc::APB2ENR::set<rcc::IOPCEN>();
+    gpio::PC::CRH::modify(gpio::MODE<13>::is<gpio::OUT_2MHZ>(),
+                          gpio::CNF<13>::is<gpio::PUSH_PULL>());
+    gpio_on();
+}
+
+/* BRR and BSRR are write-only: one store each, no load. */
+void gpio_on(void)
+{
+    gpio::PC::BRR::write(gpio::BRR<13>::set());
+}
+
+void gpio_off(void)
+{
+    gpio::PC::BSRR::write(gpio::BS<13>::set());
+}
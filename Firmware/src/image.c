@@ -0,0 +1,64 @@
+/**
+ * @file   image.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Firmware image validation and slot selection.
+ */
+
+#include "crc.h"
+#include "image.h"
+
+#define SRAM_START  0x20000000
+#define SRAM_END    (SRAM_START + 64 * 1024)
+
+uint32_t image_header_crc(const image_header_t *hdr)
+{
+    return crc32_hw((const uint32_t *) hdr,
+                    (sizeof(image_header_t) - sizeof(uint32_t)) / sizeof(uint32_t));
+}
+
+/**
+ * @brief Header checks first, they are cheap. The image CRC runs on the
+ *        CRC unit, one word per bus cycle.
+ * @return 1 when the slot holds a bootable image.
+ */
+int image_valid(uint32_t slot)
+{
+    const image_header_t *hdr = IMAGE_HEADER(slot);
+    const uint32_t *vectors = (const uint32_t *) IMAGE_VECTORS(slot);
+
+    if (hdr->magic != IMAGE_MAGIC)
+        return 0;
+    if (image_header_crc(hdr) != hdr->hdr_crc)
+        return 0;
+    if (hdr->size == 0 || hdr->size % 4 || hdr->size > SLOT_SIZE - IMAGE_HEADER_SIZE)
+        return 0;
+
+    // initial SP in SRAM, reset handler inside the image
+    if (vectors[0] <= SRAM_START || vectors[0] > SRAM_END)
+        return 0;
+    if (vectors[1] < IMAGE_VECTORS(slot) || vectors[1] >= IMAGE_VECTORS(slot) + hdr->size)
+        return 0;
+
+    return crc32_hw(vectors, hdr->size / 4) == hdr->crc;
+}
+
+/**
+ * @brief Pick the slot to boot.
+ * @return slot base address, 0 when neither slot is valid.
+ */
+uint32_t image_select(void)
+{
+    int a = image_valid(SLOT_A_BASE);
+    int b = image_valid(SLOT_B_BASE);
+
+    if (a && b) {
+        int32_t newer = IMAGE_HEADER(SLOT_B_BASE)->seq - IMAGE_HEADER(SLOT_A_BASE)->seq;
+        return newer > 0 ? SLOT_B_BASE : SLOT_A_BASE;
+    }
+    if (a)
+        return SLOT_A_BASE;
+    if (b)
+        return SLOT_B_BASE;
+    return 0;
+}
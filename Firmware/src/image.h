@@ -0,0 +1,67 @@
+/**
+ * @file   image.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Flash layout and firmware image header for the A/B bootloader.
+ *
+ *   0x08000000  16 KB  bootloader
+ *   0x08004000 112 KB  slot A: header, vector table at +0x200, image
+ *   0x08020000 112 KB  slot B
+ *   0x0803C000  16 KB  non-volatile storage (kv.h)
+ *
+ * The addresses must match startup/stm32f107xc_boot.ld and
+ * startup/stm32f107xc_slot_[ab].ld. The bootloader starts the valid
+ * image with the highest sequence number. An update is written to the
+ * other slot and its header is programmed last, which is the commit.
+ */
+
+#ifndef __IMAGE_H
+#define __IMAGE_H
+
+#include <stdint.h>
+
+#define BOOT_BASE           0x08000000
+#define BOOT_SIZE           (16 * 1024)
+#ifndef BOARD_QEMU
+#define SLOT_A_BASE         0x08004000
+#define SLOT_B_BASE         0x08020000
+#define SLOT_SIZE           (112 * 1024)
+#else
+/* Two pages of RAM each stand in for the slots, see board_qemu.h. */
+#include "stm32f107xc.h"
+#define SLOT_A_BASE         ((uint32_t) qemu_slots)
+#define SLOT_B_BASE         ((uint32_t) qemu_slots + SLOT_SIZE)
+#define SLOT_SIZE           (4 * 1024)
+#endif
+#define STORAGE_BASE        0x0803C000
+#define STORAGE_SIZE        (16 * 1024)
+
+/* The vector table needs 512 byte alignment (84 entries). */
+#define IMAGE_HEADER_SIZE   0x200
+#define IMAGE_MAGIC         0x4D42334D      /* "M3BM" */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;           /* higher is newer */
+    uint32_t size;          /* bytes after the header, multiple of 4 */
+    uint32_t crc;           /* crc32_hw() of those bytes */
+    uint32_t reserved[3];
+    uint32_t hdr_crc;       /* crc32_hw() of the words above */
+} image_header_t;
+
+#define IMAGE_HEADER(slot)  ((const image_header_t *) (slot))
+#define IMAGE_VECTORS(slot) ((slot) + IMAGE_HEADER_SIZE)
+
+/* Base of the slot the running image was started from. */
+#ifndef BOARD_QEMU
+#define IMAGE_RUNNING()     (SCB_VTOR - IMAGE_HEADER_SIZE)
+#else
+#define IMAGE_RUNNING()     qemu_running_slot
+#endif
+
+uint32_t image_header_crc(const image_header_t *hdr);
+int image_valid(uint32_t slot);
+uint32_t image_select(void);
+
+#endif /* __IMAGE_H */
@@ -0,0 +1,503 @@
+/**
+ * @file   kv.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Log-structured key-value store in internal flash.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "stm32f107xc.h"
+#include "crc.h"
+#include "flash.h"
+#include "image.h"
+#include "kv.h"
+
+#ifdef BOARD_QEMU
+#define KV_BASE         ((uint32_t) qemu_storage)
+#else
+#define KV_BASE         STORAGE_BASE
+#endif
+#define KV_PAGES        (STORAGE_SIZE / FLASH_PAGE_SIZE)
+#define KV_PAYLOAD      (FLASH_PAGE_SIZE - sizeof(kv_page_hdr_t))
+
+#define PAGE_FREE       0       /* erased */
+#define PAGE_ACTIVE     1       /* part of the log */
+#define PAGE_DIRTY      2       /* to be erased */
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t erases;
+    uint16_t used;      /* bytes, header included */
+    uint16_t dead;      /* bytes of superseded and broken records */
+    uint8_t  state;
+} kv_page_t;
+
+typedef struct
+{
+    uint16_t key;
+    uint16_t len;
+    uint32_t addr;      /* of the record */
+} kv_slot_t;
+
+static kv_page_t pages[KV_PAGES];
+static uint8_t   order[KV_PAGES];       /* active pages, oldest first */
+static uint32_t  active;
+static uint32_t  next_seq;
+static int       erasing = -1;
+
+static kv_slot_t slots[KV_INDEX_SIZE];
+static uint32_t  keys;
+
+static inline uint32_t page_addr(uint32_t page)
+{
+    return KV_BASE + page * FLASH_PAGE_SIZE;
+}
+
+static inline uint32_t page_of(uint32_t addr)
+{
+    return (addr - KV_BASE) / FLASH_PAGE_SIZE;
+}
+
+static inline uint32_t record_size(uint32_t len)
+{
+    return sizeof(kv_record_t) + ((len + 3) & ~3);
+}
+
+static uint32_t record_crc(uint32_t addr)
+{
+    const kv_record_t *rec = (const kv_record_t *) addr;
+
+    return crc32_hw((const uint32_t *) (addr + sizeof(kv_record_t)), (rec->len + 3) / 4)
+         ^ ((uint32_t) rec->len << 16 | rec->key);
+}
+
+/**
+ * @brief An erased page, apart from the erase count in its header.
+ */
+static int page_blank(uint32_t page)
+{
+    const uint32_t *p = (const uint32_t *) page_addr(page);
+
+    for (uint32_t i = 0; i < FLASH_PAGE_SIZE / 4; ++i)
+        if (p[i] != 0xFFFFFFFF && i != offsetof(kv_page_hdr_t, erases) / 4)
+            return 0;
+    return 1;
+}
+
+static uint32_t free_pages(void)
+{
+    uint32_t n = 0;
+
+    for (uint32_t p = 0; p < KV_PAGES; ++p)
+        n += pages[p].state == PAGE_FREE;
+    return n;
+}
+
+/* Index: open addressing, linear probing. -------------------------------- */
+
+static inline uint32_t kv_hash(uint16_t key)
+{
+    return (key * 2654435761u) >> 24 & (KV_INDEX_SIZE - 1);
+}
+
+/**
+ * @return slot holding `key`, or the empty slot where it belongs.
+ */
+static uint32_t index_find(uint16_t key)
+{
+    uint32_t i = kv_hash(key);
+
+    while (slots[i].key != key && slots[i].key != KV_KEY_NONE)
+        i = (i + 1) & (KV_INDEX_SIZE - 1);
+    return i;
+}
+
+/**
+ * @brief Backward-shift deletion, keeps every probe chain unbroken
+ *        without tombstones in the index.
+ */
+static void index_remove(uint32_t i)
+{
+    uint32_t j = i;
+
+    while (1) {
+        j = (j + 1) & (KV_INDEX_SIZE - 1);
+        if (slots[j].key == KV_KEY_NONE)
+            break;
+        // move slot j into the hole if the hole is on its probe path
+        uint32_t home = kv_hash(slots[j].key);
+        if (((j - home) & (KV_INDEX_SIZE - 1)) >= ((j - i) & (KV_INDEX_SIZE - 1))) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i].key = KV_KEY_NONE;
+}
+
+/**
+ * @brief Make the record at `addr` the current one of its key.
+ */
+static void index_apply(uint16_t key, uint16_t len, uint32_t addr)
+{
+    uint32_t i = index_find(key);
+
+    if (slots[i].key == key)
+        pages[page_of(slots[i].addr)].dead += record_size(slots[i].len);
+
+    if (len == 0) {
+        // a delete record is dead as soon as it is written: garbage
+        // collection drops it when no older page is left
+        pages[page_of(addr)].dead += record_size(0);
+        if (slots[i].key == key) {
+            index_remove(i);
+            keys--;
+        }
+        return;
+    }
+
+    if (slots[i].key != key) {
+        if (keys == KV_MAX_KEYS) {
+            pages[page_of(addr)].dead += record_size(len);
+            return;
+        }
+        slots[i].key = key;
+        keys++;
+    }
+    slots[i].len = len;
+    slots[i].addr = addr;
+}
+
+/* Log. ------------------------------------------------------------------- */
+
+/**
+ * @brief Replay the records of an active page into the index.
+ */
+static void page_scan(uint32_t page)
+{
+    uint32_t base = page_addr(page);
+    uint32_t off = sizeof(kv_page_hdr_t);
+
+    while (off + sizeof(kv_record_t) <= FLASH_PAGE_SIZE) {
+        const kv_record_t *rec = (const kv_record_t *) (base + off);
+        uint32_t size = record_size(rec->len);
+
+        if (rec->key == KV_KEY_NONE && rec->len == 0xFFFF)
+            break;                                  // end of the log
+        if (rec->key == KV_KEY_NONE || rec->len > KV_VALUE_MAX
+                || off + size > FLASH_PAGE_SIZE) {
+            // torn record header: nothing after it can be trusted
+            pages[page].dead += FLASH_PAGE_SIZE - off;
+            off = FLASH_PAGE_SIZE;
+            break;
+        }
+        if (rec->commit == KV_COMMITTED && rec->crc == record_crc(base + off))
+            index_apply(rec->key, rec->len, base + off);
+        else
+            pages[page].dead += size;
+        off += size;
+    }
+    pages[page].used = off;
+}
+
+/**
+ * @brief Start a new head page, the least worn free one.
+ * @return page number, -1 on a flash error.
+ */
+static int page_open(void)
+{
+    int page = -1;
+
+    for (uint32_t p = 0; p < KV_PAGES; ++p)
+        if (pages[p].state == PAGE_FREE && (page < 0 || pages[p].erases < pages[page].erases))
+            page = p;
+    if (page < 0)
+        return -1;
+
+    kv_page_hdr_t hdr = { next_seq, pages[page].erases, 0xFFFFFFFF, KV_PAGE_MAGIC };
+    uint32_t addr = page_addr(page);
+    int status;
+
+    flash_unlock();
+    status = flash_program(addr, &hdr.seq, 4);
+    if (status == FLASH_OK && ((const kv_page_hdr_t *) addr)->erases == 0xFFFFFFFF)
+        status = flash_program(addr + offsetof(kv_page_hdr_t, erases), &hdr.erases, 4);
+    if (status == FLASH_OK)
+        status = flash_program(addr + offsetof(kv_page_hdr_t, magic), &hdr.magic, 4);
+    flash_lock();
+    if (status != FLASH_OK) {
+        pages[page].state = PAGE_DIRTY;
+        return -1;
+    }
+
+    pages[page].state = PAGE_ACTIVE;
+    pages[page].seq = next_seq++;
+    pages[page].used = sizeof(kv_page_hdr_t);
+    pages[page].dead = 0;
+    order[active++] = page;
+    return page;
+}
+
+/**
+ * @brief Append a record to the head of the log.
+ * @param reserve free pages that must stay free.
+ */
+static int kv_append(uint16_t key, const void *data, uint16_t len, uint32_t reserve)
+{
+    uint32_t size = record_size(len);
+    int head = active ? order[active - 1] : -1;
+
+    if (head < 0 || pages[head].used + size > FLASH_PAGE_SIZE) {
+        if (free_pages() <= reserve)
+            return KV_FULL;
+        if (head >= 0) {
+            pages[head].dead += FLASH_PAGE_SIZE - pages[head].used;
+            pages[head].used = FLASH_PAGE_SIZE;
+        }
+        head = page_open();
+        if (head < 0)
+            return KV_ERROR;
+    }
+
+    // the space is used up even if programming fails
+    uint32_t addr = page_addr(head) + pages[head].used;
+    pages[head].used += size;
+
+    kv_record_t rec = { key, len, 0xFFFFFFFF, 0xFFFF, 0xFFFF };
+    uint16_t commit = KV_COMMITTED;
+    int status;
+
+    flash_unlock();
+    status = flash_program(addr, &rec, 4);
+    if (status == FLASH_OK)
+        status = flash_program(addr + sizeof(kv_record_t), data, len);
+    if (status == FLASH_OK) {
+        rec.crc = record_crc(addr);
+        status = flash_program(addr + offsetof(kv_record_t, crc), &rec.crc, 4);
+    }
+    if (status == FLASH_OK)
+        status = flash_program(addr + offsetof(kv_record_t, commit), &commit, 2);
+    flash_lock();
+
+    if (status != FLASH_OK) {
+        pages[head].dead += size;
+        return KV_ERROR;
+    }
+    index_apply(key, len, addr);
+    return KV_OK;
+}
+
+/**
+ * @brief Garbage collection frees a page once the dead bytes outside
+ *        the head page add up to one.
+ */
+static int gc_worthwhile(void)
+{
+    uint32_t dead = 0;
+
+    for (uint32_t i = 0; i + 1 < active; ++i)
+        dead += pages[order[i]].dead;
+    return active > 1 && dead >= KV_PAYLOAD;
+}
+
+/**
+ * @brief What to tell a writer that found no room.
+ */
+static int kv_no_room(void)
+{
+    for (uint32_t p = 0; p < KV_PAGES; ++p)
+        if (pages[p].state == PAGE_DIRTY)
+            return KV_BUSY;
+    return gc_worthwhile() ? KV_BUSY : KV_FULL;
+}
+
+/**
+ * @brief Copy the live records of the oldest page to the head and mark
+ *        the page for erasing. Delete records are dropped: no older page
+ *        is left that they could shadow.
+ */
+static int kv_gc(void)
+{
+    uint32_t victim = order[0];
+    uint32_t lo = page_addr(victim), hi = lo + FLASH_PAGE_SIZE;
+
+    for (uint32_t i = 0; i < KV_INDEX_SIZE; ++i) {
+        // kv_append() updates slots[i] in place, the key is present
+        if (slots[i].key != KV_KEY_NONE && slots[i].addr >= lo && slots[i].addr < hi) {
+            int status = kv_append(slots[i].key, (const void *) (slots[i].addr + sizeof(kv_record_t)),
+                                   slots[i].len, 0);
+            if (status != KV_OK)
+                return status;
+        }
+    }
+
+    memmove(order, order + 1, --active);
+    pages[victim].state = PAGE_DIRTY;
+    return KV_BUSY;
+}
+
+/**
+ * @brief Rebuild the index from the log. Pages that are neither part of
+ *        the log nor erased are queued for erasing by kv_poll().
+ */
+int kv_init(void)
+{
+    crc_init();
+
+    active = 0;
+    erasing = -1;
+    for (uint32_t p = 0; p < KV_PAGES; ++p) {
+        const kv_page_hdr_t *hdr = (const kv_page_hdr_t *) page_addr(p);
+
+        memset(&pages[p], 0, sizeof(kv_page_t));
+        if (hdr->magic == KV_PAGE_MAGIC) {
+            pages[p].state = PAGE_ACTIVE;
+            pages[p].seq = hdr->seq;
+            pages[p].erases = hdr->erases;
+
+            // insertion sort by sequence number
+            uint32_t i = active++;
+            for (; i > 0 && pages[order[i - 1]].seq > hdr->seq; --i)
+                order[i] = order[i - 1];
+            order[i] = p;
+        } else {
+            // the erase count is the best guess left after a torn erase
+            pages[p].state = page_blank(p) ? PAGE_FREE : PAGE_DIRTY;
+            if (hdr->erases != 0xFFFFFFFF)
+                pages[p].erases = hdr->erases;
+        }
+    }
+
+    memset(slots, 0xFF, sizeof(slots));
+    keys = 0;
+    for (uint32_t i = 0; i < active; ++i)
+        page_scan(order[i]);
+
+    // only the head page is appended to
+    for (uint32_t i = 0; i + 1 < active; ++i) {
+        kv_page_t *page = &pages[order[i]];
+        page->dead += FLASH_PAGE_SIZE - page->used;
+        page->used = FLASH_PAGE_SIZE;
+    }
+
+    next_seq = active ? pages[order[active - 1]].seq + 1 : 1;
+    return KV_OK;
+}
+
+/**
+ * @brief Background work: finish an erase, start the next one, or
+ *        collect the oldest page when free pages run low. Each call does
+ *        one step, an erase runs on while kv_poll() returns.
+ * @return KV_BUSY while work is left, KV_OK when idle, KV_ERROR.
+ */
+int kv_poll(void)
+{
+    if (erasing >= 0) {
+        int status = flash_status();
+
+        if (status == FLASH_BUSY)
+            return KV_BUSY;
+        if (status == FLASH_OK && page_blank(erasing)) {
+            // keep the erase count while the page is free
+            uint32_t erases = pages[erasing].erases + 1;
+            status = flash_program(page_addr(erasing) + offsetof(kv_page_hdr_t, erases), &erases, 4);
+            if (status == FLASH_OK) {
+                pages[erasing].state = PAGE_FREE;
+                pages[erasing].erases = erases;
+            }
+        }
+        flash_lock();
+        erasing = -1;
+        if (status != FLASH_OK)
+            return KV_ERROR;
+    }
+
+    for (uint32_t p = 0; p < KV_PAGES; ++p) {
+        if (pages[p].state == PAGE_DIRTY) {
+            erasing = p;
+            flash_unlock();
+            flash_start_erase(page_addr(p));
+            return KV_BUSY;
+        }
+    }
+
+    if (free_pages() <= KV_RESERVE_PAGES && gc_worthwhile())
+        return kv_gc();
+
+    return KV_OK;
+}
+
+/**
+ * @brief Look up `key`, reads straight from flash.
+ * @return length of the value, which may exceed `size` (the copy is
+ *         truncated), or KV_NOT_FOUND.
+ */
+int kv_get(uint16_t key, void *buf, uint16_t size)
+{
+    if (key == KV_KEY_NONE)
+        return KV_INVALID;
+
+    const kv_slot_t *slot = &slots[index_find(key)];
+
+    if (slot->key != key)
+        return KV_NOT_FOUND;
+    memcpy(buf, (const void *) (slot->addr + sizeof(kv_record_t)), slot->len < size ? slot->len : size);
+    return slot->len;
+}
+
+/**
+ * @brief Store a value, 1 to KV_VALUE_MAX bytes. Writing the value a key
+ *        already has costs no flash.
+ * @return KV_OK, KV_BUSY when kv_poll() has to free a page first,
+ *         KV_FULL, KV_INVALID or KV_ERROR.
+ */
+int kv_set(uint16_t key, const void *data, uint16_t len)
+{
+    if (key == KV_KEY_NONE || len == 0 || len > KV_VALUE_MAX)
+        return KV_INVALID;
+
+    const kv_slot_t *slot = &slots[index_find(key)];
+
+    if (slot->key == key) {
+        if (slot->len == len && !memcmp((const void *) (slot->addr + sizeof(kv_record_t)), data, len))
+            return KV_OK;
+    } else if (keys == KV_MAX_KEYS) {
+        return KV_FULL;
+    }
+    if (erasing >= 0)
+        return KV_BUSY;
+
+    int status = kv_append(key, data, len, KV_RESERVE_PAGES);
+    return status == KV_FULL ? kv_no_room() : status;
+}
+
+int kv_delete(uint16_t key)
+{
+    if (key == KV_KEY_NONE)
+        return KV_INVALID;
+    if (slots[index_find(key)].key != key)
+        return KV_NOT_FOUND;
+    if (erasing >= 0)
+        return KV_BUSY;
+
+    int status = kv_append(key, NULL, 0, KV_RESERVE_PAGES);
+    return status == KV_FULL ? kv_no_room() : status;
+}
+
+void kv_stats(kv_stats_t *stats)
+{
+    stats->keys = keys;
+    stats->free_pages = free_pages();
+    stats->dead_bytes = 0;
+    stats->min_erases = UINT32_MAX;
+    stats->max_erases = 0;
+    for (uint32_t p = 0; p < KV_PAGES; ++p) {
+        if (pages[p].state == PAGE_ACTIVE)
+            stats->dead_bytes += pages[p].dead;
+        if (pages[p].erases < stats->min_erases)
+            stats->min_erases = pages[p].erases;
+        if (pages[p].erases > stats->max_erases)
+            stats->max_erases = pages[p].erases;
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * @file   kv.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Log-structured key-value store in internal flash.
+ *
+ * The storage pages (STORAGE_BASE, see image.h) hold an append-only log
+ * of records. A page starts with a kv_page_hdr_t, records follow it
+ * back to back, each 4-byte aligned:
+ *
+ *   key | len | crc | commit | value, padded to 4 bytes
+ *
+ * A record counts once its commit half-word is programmed, which is the
+ * last thing written, so a reset in the middle of kv_set() leaves the
+ * old value in place. The newest record of a key wins, len 0 marks a
+ * deleted key. kv_init() rebuilds a RAM hash index from the log, which
+ * makes kv_get() a single lookup.
+ *
+ * Pages are filled in turn, the oldest page is garbage collected by
+ * copying its live records to the head of the log. Erasing a page stalls
+ * every fetch from flash for ~20 ms, so kv_set() never erases: it only
+ * programs half-words. Erasing and garbage collection happen in
+ * kv_poll(), call it from the idle loop. Interrupts stay enabled, code
+ * that must run during an erase has to live in SRAM (__RAMFUNC).
+ */
+
+#ifndef __KV_H
+#define __KV_H
+
+#include <stdint.h>
+
+#define KV_PAGE_MAGIC       0x4B56334D      /* "M3VK" */
+#define KV_COMMITTED        0x0000
+#define KV_KEY_NONE         0xFFFF
+
+#define KV_VALUE_MAX        256
+#define KV_INDEX_SIZE       256             /* power of 2 */
+#define KV_MAX_KEYS         (KV_INDEX_SIZE * 3 / 4)
+
+/* Pages kv_set() leaves free for garbage collection. */
+#define KV_RESERVE_PAGES    1
+
+// return codes
+#define KV_BUSY             1               /* call kv_poll() and retry */
+#define KV_OK               0
+#define KV_ERROR            (-1)            /* flash error */
+#define KV_NOT_FOUND        (-2)
+#define KV_FULL             (-3)
+#define KV_INVALID          (-4)
+
+typedef struct
+{
+    uint32_t seq;           /* higher is newer */
+    uint32_t erases;        /* erase count, written right after the erase */
+    uint32_t reserved;
+    uint32_t magic;         /* programmed last */
+} kv_page_hdr_t;
+
+typedef struct
+{
+    uint16_t key;
+    uint16_t len;
+    uint32_t crc;           /* crc32_hw() of the value ^ (len << 16 | key) */
+    uint16_t commit;        /* KV_COMMITTED once the record is complete */
+    uint16_t reserved;
+} kv_record_t;
+
+typedef struct
+{
+    uint32_t keys;
+    uint32_t free_pages;
+    uint32_t dead_bytes;    /* reclaimable by garbage collection */
+    uint32_t min_erases;
+    uint32_t max_erases;
+} kv_stats_t;
+
+int kv_init(void);
+int kv_poll(void);
+
+int kv_get(uint16_t key, void *buf, uint16_t size);
+int kv_set(uint16_t key, const void *data, uint16_t len);
+int kv_delete(uint16_t key);
+
+void kv_stats(kv_stats_t *stats);
+
+#endif /* __KV_H */
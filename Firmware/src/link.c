@@ -0,0 +1,310 @@
+/**
+ * @file   link.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Framed, reliable packet link.
+ *
+ * Sent data frames stay in their window slot until acknowledged. The ack
+ * field changes with every send, so the CRC is computed each time; the
+ * CRC unit does a full frame in a few hundred cycles.
+ */
+
+#include <string.h>
+#include "crc.h"
+#include "swtimer.h"
+#include "link.h"
+
+#define WINDOW_MASK         (LINK_WINDOW - 1)
+#define RTO                 SWTIMER_MS(LINK_RTO_MS)
+
+#if LINK_WINDOW & WINDOW_MASK || LINK_WINDOW > 64
+#error "LINK_WINDOW must be a power of 2, at most 64"
+#endif
+
+/**
+ * @brief Consistent overhead byte stuffing: no 0 in the output, at most
+ *        one byte more per 254. The delimiter is not added.
+ * @return encoded length.
+ */
+uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t code_at = 0;
+    uint32_t out = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < len; ++i) {
+        if (src[i]) {
+            dst[out++] = src[i];
+            code++;
+        }
+        if (!src[i] || code == 0xFF) {
+            dst[code_at] = code;
+            code = 1;
+            code_at = out++;
+        }
+    }
+    dst[code_at] = code;
+    return out;
+}
+
+/**
+ * @brief Undo cobs_encode(), without the delimiter.
+ * @return decoded length, -1 if `src` is no valid encoding or the result
+ *         does not fit in `size` bytes.
+ */
+int32_t cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t size)
+{
+    uint32_t in = 0;
+    uint32_t out = 0;
+
+    while (in < len) {
+        uint32_t code = src[in++];
+
+        if (!code || in + code - 1 > len || out + code - 1 > size)
+            return -1;
+        for (uint32_t i = 1; i < code; ++i) {
+            if (!src[in])
+                return -1;
+            dst[out++] = src[in++];
+        }
+        if (code != 0xFF && in < len) {
+            if (out == size)
+                return -1;
+            dst[out++] = 0;
+        }
+    }
+    return out;
+}
+
+static inline uint8_t *frame_bytes(link_slot_t *f)
+{
+    return (uint8_t *) f->words;
+}
+
+/* CRC of the first `len` bytes, the padding to a whole word is cleared. */
+static uint32_t frame_crc(link_slot_t *f, uint32_t len)
+{
+    uint8_t *b = frame_bytes(f);
+
+    for (uint32_t i = len; i & 3; ++i)
+        b[i] = 0;
+    return crc32_hw(f->words, (len + 3) / 4);
+}
+
+static void link_transmit(link_t *l, link_slot_t *f)
+{
+    uint8_t *b = frame_bytes(f);
+    uint32_t len = f->len;
+
+    b[2] = l->rx_next;
+    uint32_t crc = frame_crc(f, len);
+    b[len + 0] = crc;
+    b[len + 1] = crc >> 8;
+    b[len + 2] = crc >> 16;
+    b[len + 3] = crc >> 24;
+
+    uint32_t n = cobs_encode(b, len + LINK_CRC, l->wire);
+    l->wire[n++] = 0;
+    l->stats.tx_wire += n;
+    l->write(l->ctx, l->wire, n);
+}
+
+static void link_control(link_t *l, uint8_t type, uint8_t seq)
+{
+    link_slot_t f;
+
+    frame_bytes(&f)[0] = type;
+    frame_bytes(&f)[1] = seq;
+    f.len = LINK_HDR;
+    link_transmit(l, &f);
+}
+
+void link_init(link_t *l, link_write_t *write, link_recv_t *recv, void *ctx)
+{
+    memset(l, 0, sizeof(*l));
+    l->write = write;
+    l->recv = recv;
+    l->ctx = ctx;
+    crc_init();
+}
+
+/**
+ * @brief Send `len` bytes as one data frame.
+ * @return LINK_OK, LINK_AGAIN while LINK_WINDOW frames are in flight,
+ *         LINK_ERROR if `len` is over LINK_MTU.
+ */
+int link_send(link_t *l, const void *data, uint32_t len)
+{
+    if (len > LINK_MTU)
+        return LINK_ERROR;
+    if (!link_ready(l))
+        return LINK_AGAIN;
+
+    link_slot_t *f = &l->tx[l->tx_seq & WINDOW_MASK];
+    uint8_t *b = frame_bytes(f);
+
+    b[0] = LINK_DATA;
+    b[1] = l->tx_seq++;
+    memcpy(b + LINK_HDR, data, len);
+    f->len = LINK_HDR + len;
+    f->sent_at = swtimer_now();
+
+    l->stats.tx_frames++;
+    l->stats.tx_payload += len;
+    link_transmit(l, f);
+    return LINK_OK;
+}
+
+/* The peer expects `ack` next: everything before it has arrived. */
+static void link_acked(link_t *l, uint8_t ack)
+{
+    if ((uint8_t) (ack - l->tx_base) <= link_in_flight(l))
+        l->tx_base = ack;
+}
+
+static void link_resend(link_t *l, uint8_t seq)
+{
+    link_slot_t *f = &l->tx[seq & WINDOW_MASK];
+
+    f->sent_at = swtimer_now();
+    l->stats.retransmits++;
+    link_transmit(l, f);
+}
+
+static void link_deliver(link_t *l, link_slot_t *f)
+{
+    uint32_t len = f->len - LINK_HDR;
+
+    l->stats.rx_frames++;
+    l->stats.rx_payload += len;
+    if (l->recv)
+        l->recv(l->ctx, frame_bytes(f) + LINK_HDR, len);
+}
+
+static void link_data(link_t *l, link_slot_t *f)
+{
+    uint8_t seq = frame_bytes(f)[1];
+    uint8_t ahead = seq - l->rx_next;
+
+    if (ahead >= LINK_WINDOW) {
+        // sent again because our ACK was lost, or from beyond the window
+        l->stats.duplicates++;
+        link_control(l, LINK_ACK, 0);
+        return;
+    }
+
+    if (ahead) {
+        link_slot_t *keep = &l->rx[seq & WINDOW_MASK];
+        if (keep->used) {
+            l->stats.duplicates++;
+            return;
+        }
+        memcpy(keep->words, f->words, sizeof(f->words));
+        keep->len = f->len;
+        keep->used = 1;
+        l->stats.out_of_order++;
+
+        // ask for each missing frame before it, once
+        for (uint8_t s = l->rx_next; s != seq; ++s) {
+            link_slot_t *gap = &l->rx[s & WINDOW_MASK];
+            if (!gap->used && !gap->nacked) {
+                gap->nacked = 1;
+                l->stats.naks_sent++;
+                link_control(l, LINK_NAK, s);
+            }
+        }
+        return;
+    }
+
+    l->rx[seq & WINDOW_MASK].nacked = 0;
+    l->rx_next++;
+    link_deliver(l, f);
+
+    link_slot_t *next;
+    while ((next = &l->rx[l->rx_next & WINDOW_MASK])->used) {
+        next->used = 0;
+        next->nacked = 0;
+        l->rx_next++;
+        link_deliver(l, next);
+    }
+    link_control(l, LINK_ACK, 0);
+}
+
+static void link_frame(link_t *l)
+{
+    link_slot_t *f = &l->frame;
+    uint8_t *b = frame_bytes(f);
+    int32_t n = cobs_decode(l->raw, l->raw_len, b, LINK_FRAME_MAX);
+
+    if (n < LINK_HDR + LINK_CRC) {
+        l->stats.framing_errors++;
+        return;
+    }
+
+    uint32_t len = n - LINK_CRC;
+    uint32_t crc = b[len] | b[len + 1] << 8 | b[len + 2] << 16 | (uint32_t) b[len + 3] << 24;
+    if (frame_crc(f, len) != crc) {
+        l->stats.crc_errors++;
+        return;
+    }
+    f->len = len;
+
+    link_acked(l, b[2]);
+    switch (b[0]) {
+    case LINK_DATA:
+        link_data(l, f);
+        break;
+    case LINK_ACK:
+        break;
+    case LINK_NAK:
+        l->stats.naks_received++;
+        if ((uint8_t) (b[1] - l->tx_base) < link_in_flight(l))
+            link_resend(l, b[1]);
+        break;
+    default:
+        l->stats.framing_errors++;
+        break;
+    }
+}
+
+/**
+ * @brief Feed received bytes, in pieces of any size.
+ */
+void link_input(link_t *l, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; ++i) {
+        uint8_t c = data[i];
+
+        if (!c) {
+            if (l->raw_len && !l->rx_skip)
+                link_frame(l);
+            l->raw_len = 0;
+            l->rx_skip = 0;
+        } else if (l->rx_skip) {
+            continue;
+        } else if (l->raw_len == LINK_WIRE_MAX) {
+            l->stats.framing_errors++;
+            l->rx_skip = 1;
+        } else {
+            l->raw[l->raw_len++] = c;
+        }
+    }
+}
+
+/**
+ * @brief Send again what has not been acknowledged within LINK_RTO_MS.
+ */
+void link_poll(link_t *l)
+{
+    uint32_t now = swtimer_now();
+
+    for (uint8_t s = l->tx_base; s != l->tx_seq; ++s) {
+        if (now - l->tx[s & WINDOW_MASK].sent_at >= RTO)
+            link_resend(l, s);
+    }
+}
+
+void link_stats(const link_t *l, link_stats_t *stats)
+{
+    *stats = l->stats;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file   link.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Framed, reliable packet link over any byte stream (UART, USB
+ *         CDC): COBS framing, CRC-32, sequence numbers and selective
+ *         retransmission.
+ *
+ *     static void uart_write(void *ctx, const uint8_t *buf, uint32_t len);
+ *     static void on_packet(void *ctx, const uint8_t *data, uint32_t len);
+ *     static link_t host;
+ *
+ *     link_init(&host, uart_write, on_packet, 0);
+ *     while (1) {
+ *         n = uart_read(buf, sizeof(buf));
+ *         link_input(&host, buf, n);
+ *         link_poll(&host);
+ *         if (link_ready(&host) && samples_ready())
+ *             link_send(&host, samples, n);
+ *     }
+ *
+ * On the wire a frame is COBS encoded and ends with a 0 byte, so a
+ * receiver finds the next frame after any garbage. Decoded it is
+ *
+ *     type | seq | ack | payload (0 .. LINK_MTU) | crc32 (little endian)
+ *
+ * The CRC is the one of crc.h over the frame before it, zero-padded to
+ * whole words. `ack` is the next sequence number the sender of the frame
+ * expects, every frame acknowledges what came before it.
+ *
+ * Up to LINK_WINDOW data frames are in flight. The receiver keeps the
+ * ones that arrive ahead of a gap, sends a NAK for each missing one and
+ * delivers in order once the gap is filled; only the missing frames are
+ * sent again. A frame not acknowledged within LINK_RTO_MS is sent again
+ * from link_poll(), which covers lost NAKs and ACKs.
+ *
+ * tools/linkdecode.py is the host end. Main loop only: link_input(),
+ * link_poll() and link_send() must not interrupt each other.
+ */
+
+#ifndef __LINK_H
+#define __LINK_H
+
+#include <stdint.h>
+
+#ifndef LINK_MTU
+#define LINK_MTU            128             /* payload bytes per frame */
+#endif
+#ifndef LINK_WINDOW
+#define LINK_WINDOW         8               /* power of 2, at most 64 */
+#endif
+#define LINK_RTO_MS         100
+
+#define LINK_HDR            3
+#define LINK_CRC            4
+#define LINK_FRAME_MAX      (LINK_HDR + LINK_MTU + LINK_CRC)
+/* COBS adds a byte per 254 and one, then the delimiter. */
+#define LINK_WIRE_MAX       (LINK_FRAME_MAX + LINK_FRAME_MAX / 254 + 2)
+
+// frame types
+#define LINK_DATA           0
+#define LINK_ACK            1
+#define LINK_NAK            2               /* seq: the frame to resend */
+
+#define LINK_OK             0
+#define LINK_ERROR          (-1)            /* payload too long */
+#define LINK_AGAIN          (-2)            /* window full */
+
+typedef void link_write_t(void *ctx, const uint8_t *buf, uint32_t len);
+typedef void link_recv_t(void *ctx, const uint8_t *data, uint32_t len);
+
+typedef struct
+{
+    uint32_t tx_frames;                     /* data frames, first sends */
+    uint32_t tx_payload;                    /* bytes */
+    uint32_t tx_wire;                       /* bytes written, all frames */
+    uint32_t retransmits;
+    uint32_t rx_frames;                     /* data frames delivered */
+    uint32_t rx_payload;
+    uint32_t crc_errors;
+    uint32_t framing_errors;                /* bad COBS, too long or short */
+    uint32_t duplicates;
+    uint32_t out_of_order;
+    uint32_t naks_sent;
+    uint32_t naks_received;
+} link_stats_t;
+
+typedef struct
+{
+    uint32_t words[(LINK_FRAME_MAX + 3) / 4];   /* word aligned for the CRC */
+    uint16_t len;                           /* header and payload */
+    uint8_t  used;
+    uint8_t  nacked;                        /* rx: NAK sent for it */
+    uint32_t sent_at;                       /* tx: swtimer tick */
+} link_slot_t;
+
+typedef struct
+{
+    link_write_t *write;
+    link_recv_t  *recv;
+    void         *ctx;
+    uint8_t       tx_seq;                   /* next to assign */
+    uint8_t       tx_base;                  /* oldest not acknowledged */
+    uint8_t       rx_next;                  /* next to deliver */
+    uint8_t       rx_skip;                  /* discard up to the next 0 */
+    uint32_t      raw_len;
+    uint8_t       raw[LINK_WIRE_MAX];       /* received, still encoded */
+    uint8_t       wire[LINK_WIRE_MAX];      /* being sent */
+    link_slot_t   frame;                    /* received, decoded */
+    link_slot_t   tx[LINK_WINDOW];          /* by seq % LINK_WINDOW */
+    link_slot_t   rx[LINK_WINDOW];
+    link_stats_t  stats;
+} link_t;
+
+uint32_t cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst);
+int32_t  cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t size);
+
+void link_init(link_t *l, link_write_t *write, link_recv_t *recv, void *ctx);
+int  link_send(link_t *l, const void *data, uint32_t len);
+void link_input(link_t *l, const uint8_t *data, uint32_t len);
+void link_poll(link_t *l);
+void link_stats(const link_t *l, link_stats_t *stats);
+
+/* Data frames sent and not acknowledged yet. */
+static inline uint32_t link_in_flight(const link_t *l)
+{
+    return (uint8_t) (l->tx_seq - l->tx_base);
+}
+
+static inline int link_ready(const link_t *l)
+{
+    return link_in_flight(l) < LINK_WINDOW;
+}
+
+#endif /* __LINK_H */
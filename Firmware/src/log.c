@@ -0,0 +1,183 @@
+/**
+ * @file   log.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Tokenized binary logging.
+ *
+ * The ring is multi-producer, single-consumer. A producer reserves its
+ * words by moving `head` with LDREX/STREX (an exception in between
+ * makes the STREX fail and the reservation is retried), fills them and
+ * writes the header last. The consumer stops at the first header that
+ * is not written yet and zeroes what it took, so a stale header is
+ * never mistaken for a new one.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "stm32f107xc.h"
+#include "log.h"
+
+#define RING_MASK       (LOG_RING_WORDS - 1)
+#define RECORD_WORDS    (2 + LOG_MAX_ARGS)
+
+// RCC_APB2ENR, RCC_AHBENR
+#define AFIOEN          0
+#define IOPAEN          2
+#define USART1EN        14
+#define DMA1EN          0
+
+// USART_CR1, USART_CR3
+#define USART_CR1_TE    (1 << 3)
+#define USART_CR1_UE    (1 << 13)
+#define USART_CR3_DMAT  (1 << 7)
+
+// DMA_CCR
+#define DMA_CCR_EN      (1 << 0)
+#define DMA_CCR_DIR     (1 << 4)
+#define DMA_CCR_MINC    (1 << 7)
+
+// USART1 TX is DMA1 channel 4
+#define LOG_DMA         DMA1_Channel4
+#define LOG_UART_BUF    256             /* bytes per DMA transfer */
+
+static uint32_t ring[LOG_RING_WORDS];
+static uint32_t ring_head;              /* next word to reserve */
+static uint32_t ring_tail;              /* next word to read */
+static uint32_t dropped;                /* not reported yet */
+static log_stats_t stats;
+
+static uint32_t uart_buf[LOG_UART_BUF / 4];
+
+void log_init(void)
+{
+    memset(ring, 0, sizeof(ring));
+    ring_head = 0;
+    ring_tail = 0;
+    dropped = 0;
+    stats.logged = 0;
+    stats.dropped = 0;
+    dwt_enable();
+}
+
+/**
+ * @brief Append one record, callable from any context.
+ * @param hdr ID and argument count, see log.h.
+ */
+void log_push(uint32_t hdr, const uint32_t *args, uint32_t nargs)
+{
+    uint32_t len = 2 + nargs;
+    uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+
+    do {
+        uint32_t tail = __atomic_load_n(&ring_tail, __ATOMIC_ACQUIRE);
+        if (head - tail + len > LOG_RING_WORDS) {
+            __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&stats.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&ring_head, &head, head + len, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    ring[(head + 1) & RING_MASK] = dwt_cycles();
+    for (uint32_t i = 0; i < nargs; ++i)
+        ring[(head + 2 + i) & RING_MASK] = args[i];
+    __atomic_store_n(&ring[head & RING_MASK], hdr | LOG_HDR_VALID, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&stats.logged, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Take whole records out of the ring, single consumer only. A
+ *        drop report record comes first when messages were lost.
+ * @return number of words stored in `buf`.
+ */
+uint32_t log_read(uint32_t *buf, uint32_t words)
+{
+    uint32_t tail = ring_tail;
+    uint32_t out = 0;
+
+    if (__atomic_load_n(&dropped, __ATOMIC_RELAXED) && words >= 3) {
+        buf[out++] = LOG_HDR_VALID | 1UL << 28 | LOG_ID_DROPPED;
+        buf[out++] = dwt_cycles();
+        buf[out++] = __atomic_exchange_n(&dropped, 0, __ATOMIC_RELAXED);
+    }
+
+    while (1) {
+        uint32_t hdr = __atomic_load_n(&ring[tail & RING_MASK], __ATOMIC_ACQUIRE);
+        if (!(hdr & LOG_HDR_VALID))
+            break;                              // empty, or not written yet
+
+        uint32_t len = 2 + LOG_HDR_NARGS(hdr);
+        if (out + len > words)
+            break;
+        for (uint32_t i = 0; i < len; ++i) {
+            buf[out++] = ring[(tail + i) & RING_MASK];
+            ring[(tail + i) & RING_MASK] = 0;
+        }
+        tail += len;
+        __atomic_store_n(&ring_tail, tail, __ATOMIC_RELEASE);
+    }
+    return out;
+}
+
+void log_stats(log_stats_t *s)
+{
+    *s = stats;
+}
+
+/**
+ * @brief Drain over ITM stimulus port 0 (SWO). Messages are discarded
+ *        while no trace tool has enabled the port.
+ */
+void log_drain_itm(void)
+{
+    uint32_t buf[RECORD_WORDS];
+    uint32_t n;
+
+    while ((n = log_read(buf, RECORD_WORDS))) {
+        if (!(ITM_TCR & ITM_TCR_ITMENA) || !(ITM_TER & 1))
+            continue;
+        for (uint32_t i = 0; i < n; ++i) {
+            while (!ITM_STIM0)
+                ;
+            ITM_STIM0 = buf[i];
+        }
+    }
+}
+
+/**
+ * @brief USART1 on PA9, 8N1, transmit only, fed by DMA1 channel 4.
+ */
+void log_uart_init(uint32_t pclk_hz, uint32_t baud)
+{
+    RCC->APB2ENR |= (1 << IOPAEN) | (1 << AFIOEN) | (1 << USART1EN);
+    RCC->AHBENR  |= (1 << DMA1EN);
+
+    // PA9: alternate function push-pull, 50 MHz
+    PORTA->CRH = (PORTA->CRH & ~(0xF << 4)) | (0xB << 4);
+
+    USART1->BRR = (pclk_hz + baud / 2) / baud;
+    USART1->CR3 = USART_CR3_DMAT;
+    USART1->CR1 = USART_CR1_UE | USART_CR1_TE;
+
+    LOG_DMA->CCR = 0;
+    LOG_DMA->CPAR = (uint32_t) &USART1->DR;
+}
+
+/**
+ * @brief Start the next DMA transfer once the last one is done. Call it
+ *        from the main loop, it never waits.
+ */
+void log_drain_uart(void)
+{
+    if ((LOG_DMA->CCR & DMA_CCR_EN) && LOG_DMA->CNDTR)
+        return;
+
+    uint32_t n = log_read(uart_buf, LOG_UART_BUF / 4);
+    if (!n)
+        return;
+
+    LOG_DMA->CCR = 0;
+    LOG_DMA->CMAR = (uint32_t) uart_buf;
+    LOG_DMA->CNDTR = n * 4;
+    LOG_DMA->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file   log.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Tokenized binary logging.
+ *
+ *     LOG_INFO("adc %u mV, gain %d", mv, gain);
+ *
+ * The format string, with level, file and line, goes into the .log_fmt
+ * section, which is kept in the ELF but not loaded (sections.ld). Its
+ * offset in that section is the message ID, resolved by the linker.
+ * A log call only pushes the ID, a timestamp and the raw arguments into
+ * a lock-free ring, a few dozen cycles, from thread or interrupt code.
+ * The main loop drains the ring over ITM or UART DMA and
+ * tools/logdecode.py formats the messages on the host from the ELF.
+ *
+ * Arguments are passed as 32-bit words: integers, characters and
+ * pointers, up to LOG_MAX_ARGS. %s prints the pointer, the host cannot
+ * read target memory. When the ring is full, messages are dropped and
+ * counted, the count is reported in the stream as soon as there is room.
+ *
+ * Record in the ring and on the wire, little-endian words:
+ *
+ *   header     1 | nargs (3 bits) | 4 bits 0 | ID (24 bits)
+ *   timestamp  DWT cycle counter
+ *   nargs arguments
+ */
+
+#ifndef __LOG_H
+#define __LOG_H
+
+#include <stdint.h>
+
+#define LOG_LEVEL_DEBUG     0
+#define LOG_LEVEL_INFO      1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_ERROR     3
+
+/* Calls below this level compile to nothing. */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL           LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_RING_WORDS
+#define LOG_RING_WORDS      256             /* power of 2 */
+#endif
+
+#define LOG_MAX_ARGS        4
+#define LOG_HDR_VALID       (1UL << 31)
+#define LOG_HDR_NARGS(hdr)  (((hdr) >> 28) & 0x7)
+#define LOG_ID_MASK         0x00FFFFFF
+#define LOG_ID_DROPPED      LOG_ID_MASK     /* 1 argument: messages lost */
+
+typedef struct
+{
+    uint32_t logged;
+    uint32_t dropped;
+} log_stats_t;
+
+void log_init(void);
+void log_push(uint32_t hdr, const uint32_t *args, uint32_t nargs);
+uint32_t log_read(uint32_t *buf, uint32_t words);
+void log_stats(log_stats_t *stats);
+
+void log_drain_itm(void);
+void log_uart_init(uint32_t pclk_hz, uint32_t baud);
+void log_drain_uart(void);
+
+static inline void log_write0(uint32_t id)
+{
+    log_push(id & LOG_ID_MASK, 0, 0);
+}
+
+static inline void log_write1(uint32_t id, uint32_t a)
+{
+    log_push((id & LOG_ID_MASK) | 1UL << 28, &a, 1);
+}
+
+static inline void log_write2(uint32_t id, uint32_t a, uint32_t b)
+{
+    uint32_t args[2] = { a, b };
+    log_push((id & LOG_ID_MASK) | 2UL << 28, args, 2);
+}
+
+static inline void log_write3(uint32_t id, uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t args[3] = { a, b, c };
+    log_push((id & LOG_ID_MASK) | 3UL << 28, args, 3);
+}
+
+static inline void log_write4(uint32_t id, uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    uint32_t args[4] = { a, b, c, d };
+    log_push((id & LOG_ID_MASK) | 4UL << 28, args, 4);
+}
+
+#define LOG_STR_(x)         #x
+#define LOG_STR(x)          LOG_STR_(x)
+#define LOG_CAT_(a, b)      a##b
+#define LOG_CAT(a, b)       LOG_CAT_(a, b)
+
+/* Number of arguments after the format string, 0 to 4. */
+#define LOG_NARGS(...)      LOG_NARGS_(__VA_ARGS__, 4, 3, 2, 1, 0, _)
+#define LOG_NARGS_(fmt, a, b, c, d, n, ...) n
+#define LOG_FMT(fmt, ...)   fmt
+
+#define LOG_ARGS_0(fmt)
+#define LOG_ARGS_1(fmt, a)          , (uint32_t) (a)
+#define LOG_ARGS_2(fmt, a, b)       , (uint32_t) (a), (uint32_t) (b)
+#define LOG_ARGS_3(fmt, a, b, c)    , (uint32_t) (a), (uint32_t) (b), (uint32_t) (c)
+#define LOG_ARGS_4(fmt, a, b, c, d) , (uint32_t) (a), (uint32_t) (b), (uint32_t) (c), (uint32_t) (d)
+
+#define LOG_EMIT(level, ...)                                                    \
+    do {                                                                        \
+        static const char log_fmt_[] __attribute__((section(".log_fmt"), used)) = \
+            level "|" __FILE__ ":" LOG_STR(__LINE__) "|" LOG_FMT(__VA_ARGS__, _); \
+        LOG_CAT(log_write, LOG_NARGS(__VA_ARGS__))((uint32_t) log_fmt_         \
+            LOG_CAT(LOG_ARGS_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__));           \
+    } while (0)
+
+#define LOG_NONE(...)       do { } while (0)
+
+#if LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)      LOG_EMIT("D", __VA_ARGS__)
+#else
+#define LOG_DEBUG(...)      LOG_NONE(__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...)       LOG_EMIT("I", __VA_ARGS__)
+#else
+#define LOG_INFO(...)       LOG_NONE(__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...)       LOG_EMIT("W", __VA_ARGS__)
+#else
+#define LOG_WARN(...)       LOG_NONE(__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)      LOG_EMIT("E", __VA_ARGS__)
+#else
+#define LOG_ERROR(...)      LOG_NONE(__VA_ARGS__)
+#endif
+
+#endif /* __LOG_H */
@@ -0,0 +1,554 @@
+/**
+ * @file   net.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  UDP/IPv4 with ARP and ICMP echo, in the Ethernet DMA buffers.
+ *
+ * Headers are read and written a byte at a time, they are not aligned
+ * behind the 14 byte Ethernet header. Checksum fields go out as zero,
+ * the MAC fills them in (TDES0.CIC), and a received IPv4 frame with a
+ * bad checksum is flagged in RDES0, nothing is summed in software.
+ *
+ * The ARP table is a handful of entries searched linearly, the entry
+ * found last is tried first. A resolved entry is refreshed after
+ * NET_ARP_TIMEOUT_MS and its MAC stays in use until the refresh fails.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "eth.h"
+#include "net.h"
+#include "swtimer.h"
+
+#define ETHERTYPE_IP        0x0800
+#define ETHERTYPE_ARP       0x0806
+
+#define IP_HDR_LEN          20
+#define IP_DF               0x4000
+#define IP_MF               0x2000
+#define IP_OFFSET           0x1FFF
+#define IP_TTL              64
+#define IP_PROTO_ICMP       1
+#define IP_PROTO_UDP        17
+
+#define UDP_HDR_LEN         8
+#define ICMP_ECHO_REPLY     0
+#define ICMP_ECHO_REQUEST   8
+
+#define ARP_LEN             28
+#define ARP_REQUEST         1
+#define ARP_REPLY           2
+
+#define ARP_RETRY           SWTIMER_MS(NET_ARP_RETRY_MS)
+#define ARP_TIMEOUT         SWTIMER_MS(NET_ARP_TIMEOUT_MS)
+
+enum {
+    ARP_FREE = 0,
+    ARP_PENDING,                            /* request out, or refreshing */
+    ARP_RESOLVED,
+};
+
+typedef struct
+{
+    uint32_t ip;
+    uint8_t  mac[6];
+    uint8_t  state;
+    uint8_t  known;                         /* mac is valid */
+    uint32_t updated;                       /* tick of the last reply */
+    uint32_t asked;                         /* tick of the last request */
+    uint32_t tries;                         /* requests since the last reply */
+} arp_entry_t;
+
+static const uint8_t broadcast_mac[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static uint8_t host_mac[6];
+static uint32_t host_ip;
+static uint32_t host_mask;
+static uint32_t host_gateway;
+static uint16_t ip_id;
+static arp_entry_t arp[NET_ARP_ENTRIES];
+static uint32_t arp_last;
+static udp_socket_t *sockets;
+static int (*other_input)(const eth_frame_t *frame);
+static net_stats_t stats;
+
+static inline uint16_t get16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t get32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+static inline void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/**
+ * @param mac Our address, the same as given to eth_init().
+ * @param ip, netmask, gateway Host byte order, see NET_IP().
+ */
+void net_init(const uint8_t mac[6], uint32_t ip, uint32_t netmask, uint32_t gateway)
+{
+    memcpy(host_mac, mac, 6);
+    host_ip = ip;
+    host_mask = netmask;
+    host_gateway = gateway;
+    memset(arp, 0, sizeof(arp));
+    arp_last = 0;
+    sockets = 0;
+    other_input = 0;
+    stats = (net_stats_t) { 0 };
+    dwt_enable();
+}
+
+/**
+ * @brief Pass frames of other EtherTypes to `fn`, e.g. ptp_input().
+ *        It returns 0 for frames it does not take.
+ */
+void net_set_input(int (*fn)(const eth_frame_t *frame))
+{
+    other_input = fn;
+}
+
+/* ---- ARP ---- */
+
+static arp_entry_t *arp_find(uint32_t ip, int create)
+{
+    arp_entry_t *e = &arp[arp_last];
+    arp_entry_t *victim = 0;
+
+    if (e->state != ARP_FREE && e->ip == ip)
+        return e;
+    for (uint32_t i = 0; i < NET_ARP_ENTRIES; ++i) {
+        e = &arp[i];
+        if (e->state != ARP_FREE && e->ip == ip) {
+            arp_last = i;
+            return e;
+        }
+        // a free entry, else the one heard from longest ago
+        if (!victim || (victim->state != ARP_FREE &&
+                        (e->state == ARP_FREE || e->updated - victim->updated > 0x80000000)))
+            victim = e;
+    }
+    if (!create)
+        return 0;
+
+    victim->ip = ip;
+    victim->state = ARP_PENDING;
+    victim->known = 0;
+    victim->updated = swtimer_now();
+    victim->tries = 0;
+    return victim;
+}
+
+static void arp_learn(uint32_t ip, const uint8_t *mac, int create)
+{
+    arp_entry_t *e = arp_find(ip, create);
+
+    if (!e)
+        return;
+    memcpy(e->mac, mac, 6);
+    e->state = ARP_RESOLVED;
+    e->known = 1;
+    e->updated = swtimer_now();
+    e->tries = 0;
+}
+
+static int arp_send(uint16_t op, const uint8_t *mac, uint32_t ip)
+{
+    uint8_t *p = eth_tx_alloc();
+
+    if (!p)
+        return NET_AGAIN;
+    memcpy(p, op == ARP_REQUEST ? broadcast_mac : mac, 6);
+    memcpy(p + 6, host_mac, 6);
+    put16(p + 12, ETHERTYPE_ARP);
+
+    uint8_t *a = p + ETH_HDR_LEN;
+    put16(a, 1);                            // Ethernet
+    put16(a + 2, ETHERTYPE_IP);
+    a[4] = 6;
+    a[5] = 4;
+    put16(a + 6, op);
+    memcpy(a + 8, host_mac, 6);
+    put32(a + 14, host_ip);
+    if (op == ARP_REQUEST)
+        memset(a + 18, 0, 6);
+    else
+        memcpy(a + 18, mac, 6);
+    put32(a + 24, ip);
+
+    eth_tx_send(ETH_HDR_LEN + ARP_LEN, 0);
+    stats.arp_tx++;
+    return NET_OK;
+}
+
+static void arp_input(const uint8_t *a, uint32_t len)
+{
+    if (len < ARP_LEN || get16(a) != 1 || get16(a + 2) != ETHERTYPE_IP ||
+        a[4] != 6 || a[5] != 4) {
+        stats.drops++;
+        return;
+    }
+
+    uint16_t op = get16(a + 6);
+    uint32_t sender = get32(a + 14);
+    int for_us = get32(a + 24) == host_ip;
+
+    // RFC 826: update a known sender, add it only if it asked for us
+    if (sender != 0)
+        arp_learn(sender, a + 8, for_us);
+    if (for_us && op == ARP_REQUEST)
+        arp_send(ARP_REPLY, a + 8, sender);
+}
+
+/* Send the requests that are due, from net_poll(). */
+static void arp_timer(uint32_t now)
+{
+    for (uint32_t i = 0; i < NET_ARP_ENTRIES; ++i) {
+        arp_entry_t *e = &arp[i];
+
+        if (e->state == ARP_FREE)
+            continue;
+        if (e->state == ARP_RESOLVED) {
+            if (now - e->updated < ARP_TIMEOUT)
+                continue;
+            e->state = ARP_PENDING;
+            e->tries = 0;
+        }
+        if (e->tries && now - e->asked < ARP_RETRY)
+            continue;
+        if (e->tries == NET_ARP_TRIES) {
+            e->state = ARP_FREE;
+            continue;
+        }
+        if (arp_send(ARP_REQUEST, 0, e->ip) != NET_OK)
+            return;
+        e->asked = now;
+        e->tries++;
+    }
+}
+
+/**
+ * @brief Write the destination MAC for `ip`: broadcast and multicast
+ *        are mapped, others go through the ARP table, off the subnet
+ *        via the gateway. Starts the resolution of an unknown address.
+ * @return NET_UNRESOLVED while the MAC is not known.
+ */
+static int next_hop(uint32_t ip, uint8_t *mac)
+{
+    if (ip == NET_BROADCAST || ip == (host_ip | ~host_mask)) {
+        memcpy(mac, broadcast_mac, 6);
+        return NET_OK;
+    }
+    if ((ip >> 28) == 0xE) {
+        mac[0] = 0x01;
+        mac[1] = 0x00;
+        mac[2] = 0x5E;
+        mac[3] = (ip >> 16) & 0x7F;
+        mac[4] = ip >> 8;
+        mac[5] = ip;
+        return NET_OK;
+    }
+    if (ip == host_ip) {
+        // to ourselves, through eth_loopback()
+        memcpy(mac, host_mac, 6);
+        return NET_OK;
+    }
+    if ((ip ^ host_ip) & host_mask)
+        ip = host_gateway;
+
+    arp_entry_t *e = arp_find(ip, 1);
+    if (!e->known)
+        return NET_UNRESOLVED;
+    memcpy(mac, e->mac, 6);
+    return NET_OK;
+}
+
+/**
+ * @brief Look up the MAC for `ip`, starting ARP if it is not known.
+ * @return 1 if it is known.
+ */
+int net_resolve(uint32_t ip)
+{
+    uint8_t mac[6];
+
+    return next_hop(ip, mac) == NET_OK;
+}
+
+/* ---- IPv4 ---- */
+
+static void icmp_input(const eth_frame_t *f, const uint8_t *ip, uint32_t ihl, uint32_t total)
+{
+    if (total < ihl + 8 || ip[ihl] != ICMP_ECHO_REQUEST || get32(ip + 16) != host_ip) {
+        stats.drops++;
+        return;
+    }
+
+    uint8_t *p = eth_tx_alloc();
+    if (!p) {
+        stats.drops++;
+        return;
+    }
+
+    // the reply carries the request's data, the one copy in the stack
+    memcpy(p, f->data + 6, 6);
+    memcpy(p + 6, host_mac, 6);
+    put16(p + 12, ETHERTYPE_IP);
+    uint8_t *r = p + ETH_HDR_LEN;
+    memcpy(r, ip, total);
+    put16(r + 6, 0);
+    r[8] = IP_TTL;
+    put16(r + 10, 0);
+    memcpy(r + 16, ip + 12, 4);
+    put32(r + 12, host_ip);
+    r[ihl] = ICMP_ECHO_REPLY;
+    put16(r + ihl + 2, 0);
+
+    eth_tx_send(ETH_HDR_LEN + total, ETH_TX_CSUM);
+    stats.icmp_echo++;
+}
+
+static void udp_input(const uint8_t *ip, uint32_t ihl, uint32_t total)
+{
+    const uint8_t *u = ip + ihl;
+    uint32_t len = total - ihl;
+
+    if (len < UDP_HDR_LEN || get16(u + 4) < UDP_HDR_LEN || get16(u + 4) > len) {
+        stats.drops++;
+        return;
+    }
+    len = get16(u + 4);
+
+    uint16_t port = get16(u + 2);
+    for (udp_socket_t *s = sockets; s; s = s->next) {
+        if (s->port == port) {
+            stats.udp_rx++;
+            if (s->recv)
+                s->recv(s, u + UDP_HDR_LEN, len - UDP_HDR_LEN, get32(ip + 12), get16(u));
+            return;
+        }
+    }
+    stats.no_port++;
+}
+
+static void ip_input(const eth_frame_t *f)
+{
+    const uint8_t *ip = f->data + ETH_HDR_LEN;
+    uint32_t len = f->len - ETH_HDR_LEN;
+
+    if (ETH_RX_CSUM_ERROR(f->status)) {
+        stats.csum_errors++;
+        return;
+    }
+
+    uint32_t ihl = (ip[0] & 0x0F) * 4;
+    uint32_t total = len >= IP_HDR_LEN ? get16(ip + 2) : 0;
+    if (len < IP_HDR_LEN || (ip[0] >> 4) != 4 || ihl < IP_HDR_LEN ||
+        total < ihl || total > len || (get16(ip + 6) & (IP_MF | IP_OFFSET))) {
+        stats.drops++;
+        return;
+    }
+
+    uint32_t dst = get32(ip + 16);
+    if (dst != host_ip && dst != NET_BROADCAST && dst != (host_ip | ~host_mask) &&
+        (dst >> 28) != 0xE) {
+        stats.drops++;
+        return;
+    }
+
+    switch (ip[9]) {
+    case IP_PROTO_UDP:
+        udp_input(ip, ihl, total);
+        break;
+    case IP_PROTO_ICMP:
+        icmp_input(f, ip, ihl, total);
+        break;
+    default:
+        stats.drops++;
+        break;
+    }
+}
+
+static void net_input(const eth_frame_t *f)
+{
+    if (f->len < ETH_HDR_LEN) {
+        stats.drops++;
+        return;
+    }
+
+    switch (get16(f->data + 12)) {
+    case ETHERTYPE_IP:
+        ip_input(f);
+        break;
+    case ETHERTYPE_ARP:
+        arp_input(f->data + ETH_HDR_LEN, f->len - ETH_HDR_LEN);
+        break;
+    default:
+        if (!other_input || !other_input(f))
+            stats.drops++;
+        break;
+    }
+}
+
+/**
+ * @brief Handle the frames received so far, at most one ring's worth so
+ *        that a flood cannot hold up the main loop, and send the ARP
+ *        requests that are due.
+ * @return number of frames handled.
+ */
+int net_poll(void)
+{
+    eth_frame_t f;
+    int n = 0;
+
+    while (n < ETH_RX_BUFS && eth_rx(&f)) {
+        uint32_t start = dwt_cycles();
+
+        net_input(&f);
+        eth_rx_release(&f);
+
+        uint32_t cycles = dwt_cycles() - start;
+        stats.rx++;
+        stats.rx_cycles += cycles;
+        if (cycles > stats.rx_cycles_max)
+            stats.rx_cycles_max = cycles;
+        n++;
+    }
+
+    arp_timer(swtimer_now());
+    return n;
+}
+
+/* ---- UDP ---- */
+
+/**
+ * @brief Receive datagrams for `port` through `recv`.
+ * @return NET_ERROR if the port is 0 or taken.
+ */
+int udp_bind(udp_socket_t *s, uint16_t port, udp_recv_t recv, void *arg)
+{
+    if (port == 0)
+        return NET_ERROR;
+    for (udp_socket_t *o = sockets; o; o = o->next)
+        if (o->port == port)
+            return NET_ERROR;
+
+    s->port = port;
+    s->recv = recv;
+    s->arg = arg;
+    s->remote_ip = 0;
+    s->remote_port = 0;
+    s->next = sockets;
+    sockets = s;
+    return NET_OK;
+}
+
+void udp_unbind(udp_socket_t *s)
+{
+    for (udp_socket_t **pp = &sockets; *pp; pp = &(*pp)->next) {
+        if (*pp == s) {
+            *pp = s->next;
+            break;
+        }
+    }
+    s->port = 0;
+}
+
+/**
+ * @brief Set the destination for udp_send() and start resolving it.
+ */
+int udp_connect(udp_socket_t *s, uint32_t ip, uint16_t port)
+{
+    if (s->port == 0 || port == 0)
+        return NET_ERROR;
+    s->remote_ip = ip;
+    s->remote_port = port;
+    net_resolve(ip);
+    return NET_OK;
+}
+
+/**
+ * @brief Payload area of the next transmit buffer, UDP_MAX_PAYLOAD bytes.
+ *        It stays the same until a frame is sent.
+ * @return NULL while the DMA owns the buffer.
+ */
+uint8_t *udp_alloc(void)
+{
+    uint8_t *p = eth_tx_alloc();
+
+    return p ? p + UDP_PAYLOAD_OFFSET : 0;
+}
+
+/**
+ * @brief Send the `len` bytes written to the udp_alloc() buffer.
+ * @return NET_AGAIN if the DMA still owns the buffer, NET_UNRESOLVED if
+ *         the destination's MAC is not known yet, see net.h.
+ */
+int udp_sendto(udp_socket_t *s, uint32_t ip, uint16_t port, uint32_t len)
+{
+    uint32_t start = dwt_cycles();
+
+    if (s->port == 0 || port == 0 || len > UDP_MAX_PAYLOAD)
+        return NET_ERROR;
+
+    uint8_t *p = eth_tx_alloc();
+    if (!p)
+        return NET_AGAIN;
+    if (next_hop(ip, p) != NET_OK)
+        return NET_UNRESOLVED;
+    memcpy(p + 6, host_mac, 6);
+    put16(p + 12, ETHERTYPE_IP);
+
+    uint8_t *h = p + ETH_HDR_LEN;
+    h[0] = 0x45;
+    h[1] = 0;
+    put16(h + 2, IP_HDR_LEN + UDP_HDR_LEN + len);
+    put16(h + 4, ip_id++);
+    put16(h + 6, IP_DF);
+    h[8] = IP_TTL;
+    h[9] = IP_PROTO_UDP;
+    put16(h + 10, 0);
+    put32(h + 12, host_ip);
+    put32(h + 16, ip);
+
+    uint8_t *u = h + IP_HDR_LEN;
+    put16(u, s->port);
+    put16(u + 2, port);
+    put16(u + 4, UDP_HDR_LEN + len);
+    put16(u + 6, 0);
+
+    eth_tx_send(UDP_PAYLOAD_OFFSET + len, ETH_TX_CSUM);
+
+    uint32_t cycles = dwt_cycles() - start;
+    stats.udp_tx++;
+    stats.tx_cycles += cycles;
+    if (cycles > stats.tx_cycles_max)
+        stats.tx_cycles_max = cycles;
+    return NET_OK;
+}
+
+int udp_send(udp_socket_t *s, uint32_t len)
+{
+    if (s->remote_port == 0)
+        return NET_ERROR;
+    return udp_sendto(s, s->remote_ip, s->remote_port, len);
+}
+
+void net_stats(net_stats_t *s)
+{
+    *s = stats;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file   net.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  UDP/IPv4 with ARP and ICMP echo, in the Ethernet DMA buffers.
+ *
+ *     static void on_cmd(udp_socket_t *s, const uint8_t *data, uint32_t len,
+ *                        uint32_t ip, uint16_t port);
+ *
+ *     eth_init(mac, hclk_hz);
+ *     net_init(mac, NET_IP(192, 168, 1, 10), NET_IP(255, 255, 255, 0),
+ *              NET_IP(192, 168, 1, 1));
+ *     udp_bind(&cmd, 5000, on_cmd, 0);
+ *     udp_bind(&stream, 5001, 0, 0);
+ *     udp_connect(&stream, host, 6000);
+ *
+ *     while (1) {
+ *         net_poll();
+ *         uint8_t *p = udp_alloc();
+ *         if (p && net_resolve(host) && samples_ready()) {
+ *             uint32_t n = read_samples(p, UDP_MAX_PAYLOAD);
+ *             udp_send(&stream, n);
+ *         }
+ *     }
+ *
+ * Nothing is copied on the way in or out. A receive callback gets the
+ * payload where the DMA wrote it, valid until the callback returns.
+ * udp_alloc() returns the payload area of the next transmit buffer and
+ * udp_send() writes the headers in front of it and hands the frame to
+ * the DMA. The MAC computes all IPv4, UDP and ICMP checksums on transmit
+ * and checks them on receive, the stack never touches the payload.
+ *
+ * udp_send() returns NET_UNRESOLVED until the destination's MAC is
+ * known. The ARP request goes out from net_poll() in the transmit buffer
+ * the payload was written to, so it has to be written again; a stream
+ * waits for net_resolve() before it starts. For the same reason there
+ * is no net_poll() between udp_alloc() and udp_send().
+ *
+ * Fragments, IP options on transmit and ICMP other than echo are not
+ * supported. Main loop only, like the driver.
+ */
+
+#ifndef __NET_H
+#define __NET_H
+
+#include <stdint.h>
+#include "eth.h"
+
+#ifndef NET_ARP_ENTRIES
+#define NET_ARP_ENTRIES     8
+#endif
+#define NET_ARP_RETRY_MS    500
+#define NET_ARP_TRIES       4
+#define NET_ARP_TIMEOUT_MS  300000          /* refresh resolved entries */
+
+#define NET_OK              0
+#define NET_ERROR           (-1)            /* bad argument, port in use */
+#define NET_AGAIN           (-2)            /* no transmit buffer */
+#define NET_UNRESOLVED      (-3)            /* MAC not known yet */
+
+#define NET_IP(a, b, c, d)  (((uint32_t) (a) << 24) | ((uint32_t) (b) << 16) | \
+                             ((uint32_t) (c) << 8) | (uint32_t) (d))
+#define NET_BROADCAST       0xFFFFFFFF
+
+#define UDP_PAYLOAD_OFFSET  (ETH_HDR_LEN + 20 + 8)      /* in the frame */
+#define UDP_MAX_PAYLOAD     (ETH_MTU - 20 - 8)
+
+typedef struct udp_socket udp_socket_t;
+
+/* `ip` and `port` are the sender's, host byte order. */
+typedef void (*udp_recv_t)(udp_socket_t *s, const uint8_t *data, uint32_t len,
+                           uint32_t ip, uint16_t port);
+
+struct udp_socket
+{
+    udp_socket_t *next;
+    udp_recv_t    recv;         /* NULL: datagrams are dropped */
+    void         *arg;          /* for the callback */
+    uint16_t      port;
+    uint16_t      remote_port;  /* udp_connect() */
+    uint32_t      remote_ip;
+};
+
+typedef struct
+{
+    uint32_t rx;                /* frames taken from the driver */
+    uint32_t udp_rx;
+    uint32_t udp_tx;
+    uint32_t icmp_echo;         /* echo requests answered */
+    uint32_t arp_tx;            /* requests and replies sent */
+    uint32_t drops;             /* malformed, not for us, unsupported */
+    uint32_t csum_errors;       /* flagged by the MAC */
+    uint32_t no_port;           /* UDP to an unbound port */
+    uint32_t rx_cycles;         /* sum over rx */
+    uint32_t rx_cycles_max;     /* one frame, including the callback */
+    uint32_t tx_cycles;         /* sum over udp_tx */
+    uint32_t tx_cycles_max;     /* one udp_send() */
+} net_stats_t;
+
+void net_init(const uint8_t mac[6], uint32_t ip, uint32_t netmask, uint32_t gateway);
+void net_set_input(int (*fn)(const eth_frame_t *frame));
+int  net_poll(void);
+int  net_resolve(uint32_t ip);
+
+int  udp_bind(udp_socket_t *s, uint16_t port, udp_recv_t recv, void *arg);
+void udp_unbind(udp_socket_t *s);
+int  udp_connect(udp_socket_t *s, uint32_t ip, uint16_t port);
+uint8_t *udp_alloc(void);
+int  udp_send(udp_socket_t *s, uint32_t len);
+int  udp_sendto(udp_socket_t *s, uint32_t ip, uint16_t port, uint32_t len);
+
+void net_stats(net_stats_t *stats);
+
+#endif /* __NET_H */
@@ -0,0 +1,118 @@
+/**
+ * @file   prof.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Statistical profiler on TIM7.
+ *
+ * TIM7 is a basic timer with nothing else to do on this board, its
+ * update interrupt is the sampling tick. The handler only stores the two
+ * stacked words, symbols are looked up on the host.
+ */
+
+#include "core_cm3.h"
+#include "stm32f107xc.h"
+#include "compiler.h"
+#include "prof.h"
+
+// RCC_APB1ENR
+#define TIM7EN              5
+
+// TIM_CR1, TIM_DIER, TIM_SR, TIM_EGR
+#define TIM_CR1_CEN         (1 << 0)
+#define TIM_CR1_URS         (1 << 2)        /* only overflows interrupt */
+#define TIM_DIER_UIE        (1 << 0)
+#define TIM_EGR_UG          (1 << 0)
+#define TIM_MAX             0x10000
+
+#define TIM7_IRQn           55
+
+// DBGMCU_CR
+#define DBG_TIM7_STOP       (1UL << 20)
+
+prof_buf_t prof;
+
+void prof_reset(void)
+{
+    prof.magic = PROF_MAGIC;
+    prof.count = 0;
+    prof.dropped = 0;
+}
+
+/**
+ * @brief Start sampling `rate_hz` times a second.
+ * @param tim_clock_hz TIM7 input clock: PCLK1, twice PCLK1 when the APB1
+ *        prescaler is not 1.
+ * @return PROF_ERROR if the timer cannot divide down to the rate.
+ */
+int prof_start(uint32_t tim_clock_hz, uint32_t rate_hz)
+{
+    uint32_t ticks = rate_hz ? (tim_clock_hz + rate_hz / 2) / rate_hz : 0;
+
+    if (ticks < 2)
+        return PROF_ERROR;
+
+    // the smallest prescaler that divides the period exactly, if any
+    uint32_t div = (ticks - 1) / TIM_MAX + 1;
+    for (uint32_t d = div; d <= TIM_MAX && ticks / d > 1; ++d) {
+        if (ticks % d == 0) {
+            div = d;
+            break;
+        }
+    }
+    uint32_t psc = div - 1;
+    uint32_t arr = ticks / div - 1;
+
+    prof_reset();
+    prof.rate_hz = tim_clock_hz / ((psc + 1) * (arr + 1));
+
+    RCC->APB1ENR |= (1 << TIM7EN);
+    TIM7->CR1 = TIM_CR1_URS;
+    TIM7->PSC = psc;
+    TIM7->ARR = arr;
+    TIM7->EGR = TIM_EGR_UG;                 // load the prescaler now
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+
+#ifndef BOARD_QEMU
+    // no samples of the halted core
+    DBGMCU_CR |= DBG_TIM7_STOP;
+    NVIC_IPR[TIM7_IRQn] = 0;
+    NVIC_ISER[TIM7_IRQn / 32] = 1UL << (TIM7_IRQn % 32);
+#endif
+
+    TIM7->CR1 = TIM_CR1_URS | TIM_CR1_CEN;
+    return PROF_OK;
+}
+
+void prof_stop(void)
+{
+    TIM7->CR1 = 0;
+    TIM7->DIER = 0;
+#ifndef BOARD_QEMU
+    NVIC_ICER[TIM7_IRQn / 32] = 1UL << (TIM7_IRQn % 32);
+#endif
+    TIM7->SR = 0;
+}
+
+/**
+ * @brief Record one sample. Runs from the TIM7 interrupt.
+ * @param frame exception stack frame, from TIM7_Handler (EXC_FRAME_TRAMPOLINE).
+ */
+__attribute__((used)) void prof_sample(const uint32_t *frame)
+{
+    uint32_t n = prof.count;
+
+    // first, so that the flag is clear before the return
+    TIM7->SR = 0;
+    if (n < PROF_SAMPLES) {
+        prof.samples[n].pc = frame[6];
+        prof.samples[n].lr = frame[5];
+        prof.count = n + 1;
+    } else {
+        prof.dropped++;
+    }
+}
+
+#ifndef BOARD_QEMU
+EXC_FRAME_TRAMPOLINE(TIM7_Handler, prof_sample)
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file   prof.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Statistical profiler: samples the interrupted PC and LR from
+ *         a timer interrupt.
+ *
+ *     prof_start(72000000, 10000);         // TIM7 clock, samples per second
+ *     ...                                  // the code to look at
+ *     prof_stop();
+ *
+ * TIM7 interrupts at the highest priority, so interrupt handlers are
+ * sampled too, except those at the same priority. Each sample is the PC
+ * and LR stacked on exception entry; once the buffer is full the ticks
+ * are only counted in `dropped`. The buffer is read out with the
+ * debugger and turned into a profile on the host:
+ *
+ *     (gdb) dump binary value prof.bin prof
+ *     $ python3 tools/profdecode.py build/debug/m3bm.sym prof.bin
+ *
+ * A sample costs the exception entry and exit and a dozen instructions,
+ * about 40 cycles (bench_prof measures it): 0.6 % of the core at 10 kHz
+ * and 72 MHz.
+ */
+
+#ifndef __PROF_H
+#define __PROF_H
+
+#include <stdint.h>
+
+#ifndef PROF_SAMPLES
+#define PROF_SAMPLES        512
+#endif
+
+#define PROF_MAGIC          0x464F5250      /* "PROF" */
+
+#define PROF_OK             0
+#define PROF_ERROR          (-1)
+
+typedef struct
+{
+    uint32_t pc;
+    uint32_t lr;
+} prof_sample_t;
+
+/* Layout read by tools/profdecode.py. */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t rate_hz;
+    uint32_t count;                         /* samples taken */
+    uint32_t dropped;                       /* ticks after the buffer filled */
+    prof_sample_t samples[PROF_SAMPLES];
+} prof_buf_t;
+
+extern prof_buf_t prof;
+
+int  prof_start(uint32_t tim_clock_hz, uint32_t rate_hz);
+void prof_stop(void);
+void prof_reset(void);
+void prof_sample(const uint32_t *frame);
+
+#endif /* __PROF_H */
@@ -0,0 +1,508 @@
+/**
+ * @file   ptp.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  IEEE 1588 PTP slave on the Ethernet MAC's time stamp unit.
+ *
+ * Per Sync, with t1 the master's send time, t2 our receive time and the
+ * last path delay:
+ *
+ *   offset = t2 - t1 - delay
+ *
+ * and after each Sync a Delay_Req, t3 our send time, t4 the master's
+ * receive time from the Delay_Resp:
+ *
+ *   delay = ((t2 - t3) + (t4 - t1)) / 2
+ *
+ * The PI servo turns the offset into a frequency correction in ppb,
+ * which scales the addend of the system time accumulator. It starts
+ * from the frequency error measured over the first two Syncs, so that
+ * an oscillator far off does not keep the clock stepping.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "eth.h"
+#include "ptp.h"
+
+// RCC_APB2ENR
+#define AFIOEN              0
+#define IOPBEN              3
+
+// AFIO_MAPR
+#define PTP_PPS_REMAP       (1UL << 30)
+
+// ETH_MACIMR
+#define MACIMR_TSTIM        (1 << 9)
+
+// ETH_PTPTSCR
+#define PTPTSCR_TSE         (1 << 0)
+#define PTPTSCR_TSFCU       (1 << 1)
+#define PTPTSCR_TSSTI       (1 << 2)
+#define PTPTSCR_TSSTU       (1 << 3)
+#define PTPTSCR_TSARU       (1 << 5)
+
+// ETH_PTPTSLR, ETH_PTPTSLUR
+#define PTPTSL_NEGATIVE     (1UL << 31)
+#define PTPTSL_SUBSEC       0x7FFFFFFF
+
+#define NS_PER_SEC          1000000000LL
+
+// PTPv2 messages
+#define MSG_SYNC            0x0
+#define MSG_DELAY_REQ       0x1
+#define MSG_FOLLOW_UP       0x8
+#define MSG_DELAY_RESP      0x9
+#define MSG_VERSION         2
+#define FLAG_TWO_STEP       0x02            /* first flag byte */
+#define CTRL_DELAY_REQ      1
+#define HDR_LEN             34
+#define TS_OFFSET           34              /* origin / receive timestamp */
+#define PORT_OFFSET         20              /* sourcePortIdentity */
+#define REQ_PORT_OFFSET     44              /* requestingPortIdentity */
+#define SYNC_LEN            44
+#define DELAY_RESP_LEN      54
+#define PORT_ID_LEN         10
+#define LOG_INTERVAL_MIN    (-7)            /* 128 Sync/s */
+#define LOG_INTERVAL_MAX    4               /* one Sync per 16 s */
+
+// servo gains, / 1024
+#define KP                  717             /* 0.7 */
+#define KI                  307             /* 0.3 per second */
+#define LOCK_SAMPLES        4
+
+enum {
+    SERVO_FIRST = 0,
+    SERVO_SECOND,                           /* frequency from two samples */
+    SERVO_RUNNING,
+};
+
+enum {
+    DREQ_IDLE = 0,
+    DREQ_DUE,                               /* send from ptp_poll() */
+    DREQ_SENT,                              /* waiting for t3 */
+    DREQ_WAIT_RESP,
+};
+
+static const uint8_t ptp_mcast[6] = { 0x01, 0x1B, 0x19, 0x00, 0x00, 0x00 };
+
+static uint8_t  own_mac[6];
+static uint8_t  own_port[PORT_ID_LEN];
+static uint32_t addend_base;
+static ptp_status_t status;
+
+static int      master_known;
+static int      have_delay;
+static int      lock_count;
+static int      servo_state;
+static int64_t  integral;                   /* ppb * 1024 */
+static int64_t  first_offset;
+static int64_t  first_t2;
+
+static int      sync_pending;               /* two-step, Follow_Up to come */
+static uint16_t sync_seq;
+static int8_t   sync_interval;              /* log2 seconds */
+static int64_t  sync_t2;
+static int64_t  sync_corr;
+static int      have_sync;                  /* t1, t2 usable for the delay */
+static int64_t  last_t1;
+static int64_t  last_t2;
+
+static int      dreq_state;
+static int      dreq_handle;
+static uint16_t dreq_seq;
+static int64_t  dreq_t3;
+
+static inline uint16_t get16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t get32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+/* 48-bit seconds and 32-bit nanoseconds, the seconds kept to 32 bits */
+static int64_t get_ts(const uint8_t *p)
+{
+    return (int64_t) get32(p + 2) * NS_PER_SEC + get32(p + 6);
+}
+
+/* scaled nanoseconds, ns * 2^16 */
+static int64_t get_correction(const uint8_t *p)
+{
+    uint64_t v = ((uint64_t) get32(p) << 32) | get32(p + 4);
+    return (int64_t) v >> 16;
+}
+
+static int64_t ptp_to_ns(uint32_t sec, uint32_t subsec)
+{
+    return (int64_t) sec * NS_PER_SEC +
+           (int64_t) (((uint64_t) (subsec & PTPTSL_SUBSEC) * NS_PER_SEC) >> 31);
+}
+
+int64_t ptp_ts_to_ns(const eth_ts_t *ts)
+{
+    return ptp_to_ns(ts->sec, ts->subsec);
+}
+
+/**
+ * @brief Start a time stamp unit command and wait for it. The QEMU
+ *        register image has no clock behind it, the command is applied
+ *        here instead.
+ */
+static void ptp_update(uint32_t cmd)
+{
+    ETHERNET->PTPTSCR |= cmd;
+#ifdef BOARD_QEMU
+    if (cmd == PTPTSCR_TSSTI) {
+        ETHERNET->PTPTSHR = ETHERNET->PTPTSHUR;
+        ETHERNET->PTPTSLR = ETHERNET->PTPTSLUR & PTPTSL_SUBSEC;
+    } else if (cmd == PTPTSCR_TSSTU) {
+        int64_t t = ptp_to_ns(ETHERNET->PTPTSHR, ETHERNET->PTPTSLR);
+        int64_t d = ptp_to_ns(ETHERNET->PTPTSHUR, ETHERNET->PTPTSLUR);
+        t += (ETHERNET->PTPTSLUR & PTPTSL_NEGATIVE) ? -d : d;
+        ETHERNET->PTPTSHR = t / NS_PER_SEC;
+        ETHERNET->PTPTSLR = ((uint64_t) (t % NS_PER_SEC) << 31) / NS_PER_SEC;
+    }
+    ETHERNET->PTPTSCR &= ~cmd;
+#else
+    while (ETHERNET->PTPTSCR & cmd)
+        ;
+#endif
+}
+
+/**
+ * @brief Start the system time at 0 with fine correction, forget the
+ *        master. The Ethernet MAC must be initialised.
+ */
+void ptp_init(const uint8_t mac[6], uint32_t hclk_hz)
+{
+    // subsecond increment for an update rate of about 3/4 HCLK, which
+    // leaves the addend room both ways
+    uint32_t ssinc = ((1ULL << 33) + 3ULL * hclk_hz - 1) / (3ULL * hclk_hz);
+    addend_base = (1ULL << 63) / ((uint64_t) ssinc * hclk_hz);
+
+    ETHERNET->MACIMR |= MACIMR_TSTIM;
+    ETHERNET->PTPTSCR = PTPTSCR_TSE;
+    ETHERNET->PTPSSIR = ssinc;
+    ETHERNET->PTPTSAR = addend_base;
+    ptp_update(PTPTSCR_TSARU);
+    ETHERNET->PTPTSCR |= PTPTSCR_TSFCU;
+    ETHERNET->PTPTSHUR = 0;
+    ETHERNET->PTPTSLUR = 0;
+    ptp_update(PTPTSCR_TSSTI);
+
+    memcpy(own_mac, mac, 6);
+    // EUI-64 clock identity from the MAC address, port 1
+    memcpy(own_port, mac, 3);
+    own_port[3] = 0xFF;
+    own_port[4] = 0xFE;
+    memcpy(own_port + 5, mac + 3, 3);
+    own_port[8] = 0;
+    own_port[9] = 1;
+
+    memset(&status, 0, sizeof(status));
+    master_known = 0;
+    have_delay = 0;
+    lock_count = 0;
+    servo_state = SERVO_FIRST;
+    integral = 0;
+    sync_pending = 0;
+    sync_interval = 0;
+    have_sync = 0;
+    dreq_state = DREQ_IDLE;
+}
+
+/**
+ * @brief PPS output of the system time on PB5.
+ */
+void ptp_pps_enable(void)
+{
+    RCC->APB2ENR |= (1 << AFIOEN) | (1 << IOPBEN);
+    AFIO->MAPR |= PTP_PPS_REMAP;
+    // PB5: alternate function push-pull, 50 MHz
+    PORTB->CRL = (PORTB->CRL & ~(0xFUL << 20)) | (0xBUL << 20);
+}
+
+int64_t ptp_now(void)
+{
+    uint32_t sec, subsec;
+
+    do {
+        sec = ETHERNET->PTPTSHR;
+        subsec = ETHERNET->PTPTSLR;
+    } while (sec != ETHERNET->PTPTSHR);
+    return ptp_to_ns(sec, subsec);
+}
+
+/**
+ * @brief Add `ns` to the system time at once (coarse correction).
+ */
+void ptp_clock_step(int64_t ns)
+{
+    uint64_t mag = ns < 0 ? -(uint64_t) ns : (uint64_t) ns;
+
+    ETHERNET->PTPTSHUR = mag / NS_PER_SEC;
+    ETHERNET->PTPTSLUR = (((mag % NS_PER_SEC) << 31) / NS_PER_SEC) |
+                         (ns < 0 ? PTPTSL_NEGATIVE : 0);
+    ptp_update(PTPTSCR_TSSTU);
+}
+
+/**
+ * @brief Run the system time `ppb` parts per billion fast (fine correction).
+ */
+void ptp_clock_adjfreq(int32_t ppb)
+{
+    if (ppb > PTP_MAX_PPB)
+        ppb = PTP_MAX_PPB;
+    if (ppb < -PTP_MAX_PPB)
+        ppb = -PTP_MAX_PPB;
+
+    ETHERNET->PTPTSAR = addend_base + (int64_t) addend_base * ppb / NS_PER_SEC;
+    ptp_update(PTPTSCR_TSARU);
+}
+
+static void ptp_servo(int64_t offset)
+{
+    int64_t step = offset * KI;
+
+    // the integral gain is per second of Sync interval
+    if (sync_interval > 0)
+        step *= 1 << sync_interval;
+    else if (sync_interval < 0)
+        step >>= -sync_interval;
+
+    integral += step;
+    if (integral > (int64_t) PTP_MAX_PPB * 1024)
+        integral = (int64_t) PTP_MAX_PPB * 1024;
+    if (integral < -(int64_t) PTP_MAX_PPB * 1024)
+        integral = -(int64_t) PTP_MAX_PPB * 1024;
+
+    int64_t ppb = -(offset * KP + integral) / 1024;
+    if (ppb > PTP_MAX_PPB)
+        ppb = PTP_MAX_PPB;
+    if (ppb < -PTP_MAX_PPB)
+        ppb = -PTP_MAX_PPB;
+    status.freq = ppb;
+    ptp_clock_adjfreq(ppb);
+
+    if (offset > -PTP_LOCK_NS && offset < PTP_LOCK_NS) {
+        if (++lock_count >= LOCK_SAMPLES)
+            status.state = PTP_SLAVE;
+    } else {
+        lock_count = 0;
+    }
+}
+
+static void ptp_step(int64_t offset)
+{
+    ptp_clock_step(-offset);
+    status.steps++;
+    status.state = PTP_UNCALIBRATED;
+    lock_count = 0;
+    // timestamps from before the step are of no use
+    have_sync = 0;
+    dreq_state = DREQ_IDLE;
+}
+
+/**
+ * @brief One Sync with both timestamps. The first two give the frequency
+ *        error and the clock is stepped once, then the servo steers it
+ *        and asks for a fresh path delay each time.
+ */
+static void ptp_sample(int64_t t1, int64_t t2)
+{
+    int64_t offset = t2 - t1 - status.delay;
+
+    status.syncs++;
+    status.offset = offset;
+
+    switch (servo_state) {
+    case SERVO_FIRST:
+        first_offset = offset;
+        first_t2 = t2;
+        servo_state = SERVO_SECOND;
+        break;
+
+    case SERVO_SECOND: {
+        int64_t drift = offset - first_offset;
+        int64_t interval = t2 - first_t2;
+
+        if (interval <= 0 || drift > interval || drift < -interval) {
+            servo_state = SERVO_FIRST;      // not the same master timeline
+            return;
+        }
+        int64_t ppb = status.freq - drift * NS_PER_SEC / interval;
+        if (ppb > PTP_MAX_PPB)
+            ppb = PTP_MAX_PPB;
+        if (ppb < -PTP_MAX_PPB)
+            ppb = -PTP_MAX_PPB;
+        status.freq = ppb;
+        integral = -ppb * 1024;
+        ptp_clock_adjfreq(ppb);
+        servo_state = SERVO_RUNNING;
+        if (offset > PTP_STEP_NS || offset < -PTP_STEP_NS) {
+            ptp_step(offset);
+            return;
+        }
+        break;
+    }
+
+    case SERVO_RUNNING:
+        if (offset > PTP_STEP_NS || offset < -PTP_STEP_NS) {
+            ptp_step(offset);
+            servo_state = SERVO_FIRST;
+            return;
+        }
+        if (have_delay)
+            ptp_servo(offset);
+        break;
+    }
+
+    last_t1 = t1;
+    last_t2 = t2;
+    have_sync = 1;
+    if (dreq_state != DREQ_SENT)
+        dreq_state = DREQ_DUE;
+}
+
+static void ptp_delay(int64_t t4)
+{
+    int64_t delay = ((last_t2 - dreq_t3) + (t4 - last_t1)) / 2;
+
+    dreq_state = DREQ_IDLE;
+    if (delay < 0)
+        return;                             // crossed a step or a new master
+    if (!have_delay) {
+        status.delay = delay;
+        have_delay = 1;
+    } else {
+        // smooth the jitter of the individual measurements
+        status.delay += (delay - status.delay) / 8;
+    }
+}
+
+static void ptp_dreq_timestamp(void)
+{
+    eth_ts_t ts;
+    int ready = eth_tx_timestamp(dreq_handle, &ts);
+
+    if (ready > 0) {
+        dreq_t3 = ptp_ts_to_ns(&ts);
+        dreq_state = DREQ_WAIT_RESP;
+    } else if (ready < 0) {
+        dreq_state = DREQ_IDLE;
+    }
+}
+
+static void ptp_send_delay_req(void)
+{
+    uint8_t *f = eth_tx_alloc();
+
+    if (!f)
+        return;                             // try again on the next poll
+
+    memcpy(f, ptp_mcast, 6);
+    memcpy(f + 6, own_mac, 6);
+    put16(f + 12, PTP_ETHERTYPE);
+
+    uint8_t *m = f + ETH_HDR_LEN;
+    memset(m, 0, SYNC_LEN);
+    m[0] = MSG_DELAY_REQ;
+    m[1] = MSG_VERSION;
+    put16(m + 2, SYNC_LEN);
+    memcpy(m + PORT_OFFSET, own_port, PORT_ID_LEN);
+    put16(m + 30, ++dreq_seq);
+    m[32] = CTRL_DELAY_REQ;
+    m[33] = 0x7F;
+
+    dreq_handle = eth_tx_send(ETH_HDR_LEN + SYNC_LEN, ETH_TX_TIMESTAMP);
+    dreq_state = DREQ_SENT;
+}
+
+/**
+ * @brief Handle a received frame if it is a PTP message.
+ * @return 1 if it was PTP, consumed or ignored, 0 otherwise.
+ */
+int ptp_input(const eth_frame_t *frame)
+{
+    const uint8_t *p = frame->data;
+
+    if (frame->len < ETH_HDR_LEN + HDR_LEN || get16(p + 12) != PTP_ETHERTYPE)
+        return 0;
+
+    const uint8_t *m = p + ETH_HDR_LEN;
+    uint32_t len = get16(m + 2);
+    if ((m[1] & 0x0F) != MSG_VERSION || len > frame->len - ETH_HDR_LEN)
+        return 1;
+
+    uint32_t type = m[0] & 0x0F;
+    uint16_t seq = get16(m + 30);
+
+    if (!master_known && type == MSG_SYNC) {
+        memcpy(status.master, m + PORT_OFFSET, PORT_ID_LEN);
+        master_known = 1;
+        status.state = PTP_UNCALIBRATED;
+    }
+    if (!master_known || memcmp(status.master, m + PORT_OFFSET, PORT_ID_LEN))
+        return 1;
+
+    switch (type) {
+    case MSG_SYNC:
+        if (len < SYNC_LEN)
+            break;
+        sync_seq = seq;
+        // logMessageInterval is off the wire: outside the range the servo
+        // shifts by, the last good one stays
+        if ((int8_t) m[33] >= LOG_INTERVAL_MIN && (int8_t) m[33] <= LOG_INTERVAL_MAX)
+            sync_interval = (int8_t) m[33];
+        sync_t2 = ptp_ts_to_ns(&frame->ts);
+        sync_corr = get_correction(m + 8);
+        sync_pending = m[6] & FLAG_TWO_STEP;
+        if (!sync_pending)
+            ptp_sample(get_ts(m + TS_OFFSET) + sync_corr, sync_t2);
+        break;
+
+    case MSG_FOLLOW_UP:
+        if (len < SYNC_LEN || !sync_pending || seq != sync_seq)
+            break;
+        sync_pending = 0;
+        ptp_sample(get_ts(m + TS_OFFSET) + sync_corr + get_correction(m + 8), sync_t2);
+        break;
+
+    case MSG_DELAY_RESP:
+        if (len < DELAY_RESP_LEN || seq != dreq_seq ||
+            memcmp(m + REQ_PORT_OFFSET, own_port, PORT_ID_LEN))
+            break;
+        if (dreq_state == DREQ_SENT)
+            ptp_dreq_timestamp();
+        if (dreq_state == DREQ_WAIT_RESP && have_sync)
+            ptp_delay(get_ts(m + TS_OFFSET) - get_correction(m + 8));
+        break;
+    }
+    return 1;
+}
+
+/**
+ * @brief Send the Delay_Req that is due and collect its timestamp.
+ */
+void ptp_poll(void)
+{
+    if (dreq_state == DREQ_DUE)
+        ptp_send_delay_req();
+    if (dreq_state == DREQ_SENT)
+        ptp_dreq_timestamp();
+}
+
+void ptp_status(ptp_status_t *s)
+{
+    *s = status;
+}
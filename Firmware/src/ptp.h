@@ -0,0 +1,67 @@
+/**
+ * @file   ptp.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  IEEE 1588 PTP slave on the Ethernet MAC's time stamp unit.
+ *
+ *     ptp_init(mac, hclk_hz);
+ *     ptp_pps_enable();                    // 1 Hz on PB5
+ *
+ *     while (eth_rx(&frame)) {
+ *         ptp_input(&frame);
+ *         eth_rx_release(&frame);
+ *     }
+ *     ptp_poll();
+ *
+ * PTPv2 over Ethernet (EtherType 0x88F7), end-to-end delay mechanism,
+ * one- or two-step master. There is no best master clock algorithm, the
+ * slave follows the first master it hears until ptp_init() is called
+ * again. All timestamps come from the MAC, taken at the start of frame.
+ *
+ * The system time runs from HCLK through the 32-bit addend register,
+ * the servo trims the addend (fine correction) and steps the time only
+ * when it is off by more than PTP_STEP_NS. The MAC's PPS output is the
+ * second rollover of the disciplined time.
+ */
+
+#ifndef __PTP_H
+#define __PTP_H
+
+#include <stdint.h>
+#include "eth.h"
+
+#define PTP_ETHERTYPE       0x88F7
+#define PTP_STEP_NS         100000          /* step instead of slew above this */
+#define PTP_LOCK_NS         1000            /* |offset| counted as locked */
+#define PTP_MAX_PPB         500000
+
+enum {
+    PTP_LISTENING = 0,                      /* no master yet */
+    PTP_UNCALIBRATED,
+    PTP_SLAVE,                              /* locked to the master */
+};
+
+typedef struct
+{
+    uint32_t state;
+    int64_t  offset;                        /* ns, slave - master */
+    int64_t  delay;                         /* mean path delay, ns */
+    int32_t  freq;                          /* correction, ppb */
+    uint32_t syncs;
+    uint32_t steps;
+    uint8_t  master[10];                    /* clock identity and port */
+} ptp_status_t;
+
+void ptp_init(const uint8_t mac[6], uint32_t hclk_hz);
+void ptp_pps_enable(void);
+
+int64_t ptp_now(void);
+int64_t ptp_ts_to_ns(const eth_ts_t *ts);
+void ptp_clock_step(int64_t ns);
+void ptp_clock_adjfreq(int32_t ppb);
+
+int  ptp_input(const eth_frame_t *frame);
+void ptp_poll(void);
+void ptp_status(ptp_status_t *status);
+
+#endif /* __PTP_H */
@@ -0,0 +1,211 @@
+/**
+ * @file   reg.hpp
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Typed register access for C++, header only.
+ *
+ * A register is a type made of where it is and which layout it has, a
+ * field is a type made of the layout it belongs to, its position and its
+ * access. Nothing is stored, everything is static:
+ *
+ *     struct crh;                                  // layout tag
+ *     using MODE13 = reg::field<crh, 20, 2>;
+ *     using CNF13  = reg::field<crh, 22, 2>;
+ *     using CRH    = reg::reg<location, crh>;
+ *
+ *     CRH::modify(MODE13::is<2>(), CNF13::is<0>());   // one load, one store
+ *     BSRR::write(BS13::set());                       // one store
+ *     uint32_t level = IDR::get<IDR13>();              // one load
+ *
+ * The values of all fields in one call are merged into one store, with
+ * constants the masks and bits fold into immediates. These do not
+ * compile: a field of another register, writing a read-only field,
+ * reading a write-only one, modify() on a register with write-only
+ * fields in the call, the same bits twice in one call, and a constant
+ * wider than its field.
+ *
+ * Needs C++17 (fold expressions), no library and no exceptions.
+ */
+
+#ifndef __REG_HPP
+#define __REG_HPP
+
+#include <stdint.h>
+
+namespace reg {
+
+enum class access { rw, ro, wo };
+
+/* A value for field F, already shifted into place. */
+template <typename F>
+struct value
+{
+    uint32_t bits;
+};
+
+template <typename Layout, unsigned Offset, unsigned Width, access Access = access::rw>
+struct field
+{
+    static_assert(Width > 0 && Offset + Width <= 32, "field does not fit in the register");
+
+    using layout = Layout;
+    static constexpr unsigned offset = Offset;
+    static constexpr unsigned width = Width;
+    static constexpr access mode = Access;
+    static constexpr uint32_t max = Width == 32 ? 0xFFFFFFFFu : (1u << (Width % 32)) - 1;
+    static constexpr uint32_t mask = max << Offset;
+
+    /* A run-time value, cut to the field width. */
+    static constexpr value<field> val(uint32_t v)
+    {
+        return { (v << Offset) & mask };
+    }
+
+    /* A constant, checked against the field width. */
+    template <uint32_t V>
+    static constexpr value<field> is()
+    {
+        static_assert(V <= max, "value too wide for the field");
+        return { V << Offset };
+    }
+
+    static constexpr value<field> set()
+    {
+        return { mask };
+    }
+
+    static constexpr value<field> clear()
+    {
+        return { 0 };
+    }
+};
+
+/* Location of a register that is member `M` of the peripheral `Base()`
+ * returns, so the register images of board_qemu.h work the same way. */
+template <typename P, P *(*Base)(), volatile uint32_t P::*M>
+struct member
+{
+    static volatile uint32_t *ptr()
+    {
+        return &(Base()->*M);
+    }
+};
+
+/* Location of a register at a fixed address. */
+template <uintptr_t Address>
+struct at
+{
+    static volatile uint32_t *ptr()
+    {
+        return reinterpret_cast<volatile uint32_t *>(Address);
+    }
+};
+
+namespace detail {
+
+template <typename A, typename B>
+struct same
+{
+    static constexpr bool value = false;
+};
+
+template <typename A>
+struct same<A, A>
+{
+    static constexpr bool value = true;
+};
+
+template <typename... F>
+constexpr uint32_t masks()
+{
+    return (0u | ... | F::mask);
+}
+
+template <typename... F>
+constexpr bool disjoint()
+{
+    uint32_t seen = 0;
+    bool ok = true;
+    ((ok = ok && !(seen & F::mask), seen |= F::mask), ...);
+    return ok;
+}
+
+} // namespace detail
+
+template <typename Location, typename Layout>
+struct reg
+{
+    using layout = Layout;
+
+    static volatile uint32_t &ref()
+    {
+        return *Location::ptr();
+    }
+
+    static uint32_t read()
+    {
+        return ref();
+    }
+
+    /* One field of the value read, without another load. */
+    template <typename F>
+    static constexpr uint32_t get(uint32_t snapshot)
+    {
+        static_assert(detail::same<typename F::layout, Layout>::value, "field of another register");
+        static_assert(F::mode != access::wo, "read of a write-only field");
+        return (snapshot & F::mask) >> F::offset;
+    }
+
+    template <typename F>
+    static uint32_t get()
+    {
+        return get<F>(read());
+    }
+
+    /* Store the fields, every other bit is written as 0. */
+    template <typename... F>
+    static void write(value<F>... v)
+    {
+        check<F...>();
+        static_assert(((F::mode != access::ro) && ...), "write to a read-only field");
+        ref() = (0u | ... | v.bits);
+    }
+
+    /* Read once, replace the fields, store once. */
+    template <typename... F>
+    static void modify(value<F>... v)
+    {
+        check<F...>();
+        static_assert(((F::mode == access::rw) && ...), "modify needs read-write fields");
+        constexpr uint32_t clear = detail::masks<F...>();
+        volatile uint32_t &r = ref();
+        r = (r & ~clear) | (0u | ... | v.bits);
+    }
+
+    /* All bits of the given fields to 1, or to 0. */
+    template <typename... F>
+    static void set()
+    {
+        modify(F::set()...);
+    }
+
+    template <typename... F>
+    static void clear()
+    {
+        modify(F::clear()...);
+    }
+
+private:
+    template <typename... F>
+    static constexpr void check()
+    {
+        static_assert(sizeof...(F) > 0, "no field given");
+        static_assert((detail::same<typename F::layout, Layout>::value && ...),
+                      "field of another register");
+        static_assert(detail::disjoint<F...>(), "fields overlap");
+    }
+};
+
+} // namespace reg
+
+#endif /* __REG_HPP */
@@ -0,0 +1,52 @@
+/**
+ * @file   semihost.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  ARM semihosting calls (debugger or QEMU -semihosting).
+ */
+
+#include "semihost.h"
+
+static int semihost_call(int op, void *arg)
+{
+    register int r0 __asm__("r0") = op;
+    register void *r1 __asm__("r1") = arg;
+    __asm__ volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
+    return r0;
+}
+
+void semihost_putc(char c)
+{
+    semihost_call(SYS_WRITEC, &c);
+}
+
+void semihost_puts(const char *s)
+{
+    semihost_call(SYS_WRITE0, (void *) s);
+}
+
+/**
+ * @brief Print an unsigned decimal number, no printf() needed.
+ */
+void semihost_put_u32(uint32_t value)
+{
+    char buf[11];
+    char *p = &buf[10];
+
+    *p = '\0';
+    do {
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    semihost_puts(p);
+}
+
+/**
+ * @brief Terminate the session. QEMU exits with 0 for status 0, else 1.
+ */
+void semihost_exit(int status)
+{
+    semihost_call(SYS_EXIT, (void *) (status ? ADP_Stopped_RunTimeErrorUnknown
+                                             : ADP_Stopped_ApplicationExit));
+    while (1) ;
+}
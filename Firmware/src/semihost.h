@@ -0,0 +1,31 @@
+/**
+ * @file   semihost.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  ARM semihosting calls (debugger or QEMU -semihosting).
+ *
+ * NOTE: Every call executes "bkpt 0xAB". Without a debugger or QEMU
+ *       attached the core takes a HardFault, so only use these in
+ *       test / benchmark images.
+ */
+
+#ifndef __SEMIHOST_H
+#define __SEMIHOST_H
+
+#include <stdint.h>
+
+// Semihosting operation numbers
+#define SYS_WRITEC      0x03
+#define SYS_WRITE0      0x04
+#define SYS_EXIT        0x18
+
+// SYS_EXIT reason codes
+#define ADP_Stopped_RunTimeErrorUnknown 0x20023
+#define ADP_Stopped_ApplicationExit     0x20026
+
+void semihost_putc(char c);
+void semihost_puts(const char *s);
+void semihost_put_u32(uint32_t value);
+void semihost_exit(int status) __attribute__((noreturn));
+
+#endif /* __SEMIHOST_H */
@@ -366,6 +366,24 @@ typedef struct
     __RW uint32_t CR;
 } CRC_TypeDef;
 
+/** 
+  * @brief  3.3 Embedded Flash memory: Flash memory interface
+  * @ref    PM0075 Programming manual : 4. Register descriptions
+  *             Flash register map
+  */
+typedef struct
+{
+    __RW uint32_t ACR;
+    __RW uint32_t KEYR;
+    __RW uint32_t OPTKEYR;
+    __RW uint32_t SR;
+    __RW uint32_t CR;
+    __RW uint32_t AR;
+         uint32_t RESERVED0;
+    __RW uint32_t OBR;
+    __RW uint32_t WRPR;
+} FLASH_TypeDef;
+
 /** 
   * @brief  29. Ethernet (ETH): media access control (MAC) with DMA controller
   * @ref    RM0008 Reference manual : 29.8.5 Ethernet register maps
@@ -442,12 +460,12 @@ typedef struct
   * @brief Memory Map
   * @ref   STM32F105xx, STM32F107xx (Datasheet) : 4. Memory mapping
   */
-#define FLASH_BASE          ((volatile uint32_t)0x08000000)
-#define SRAM_BASE           ((volatile uint32_t)0x20000000)
-#define PERIPHERAL_BASE     ((volatile uint32_t)0x40000000)
-#define APB1_BASE           ((volatile uint32_t)0x40000000)
-#define APB2_BASE           ((volatile uint32_t)0x40010000)
-#define AHB_BASE            ((volatile uint32_t)0x40020000)
+#define FLASH_BASE          ((uint32_t)0x08000000)
+#define SRAM_BASE           ((uint32_t)0x20000000)
+#define PERIPHERAL_BASE     ((uint32_t)0x40000000)
+#define APB1_BASE           ((uint32_t)0x40000000)
+#define APB2_BASE           ((uint32_t)0x40010000)
+#define AHB_BASE            ((uint32_t)0x40020000)
 
 // APB1
 #define TIM2                ((TIM_TypeDef *)(APB1_BASE + 0x00000000))
@@ -492,10 +510,25 @@ typedef struct
 // AHB
 #define DMA1                ((DMA_TypeDef *)(AHB_BASE + 0x00000000))
 #define DMA2                ((DMA_TypeDef *)(AHB_BASE + 0x00000400))
+#define DMA1_Channel1       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x00000008))
+#define DMA1_Channel2       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x0000001C))
+#define DMA1_Channel3       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x00000030))
+#define DMA1_Channel4       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x00000044))
+#define DMA1_Channel5       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x00000058))
+#define DMA1_Channel6       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x0000006C))
+#define DMA1_Channel7       ((DMA_Channel_TypeDef *)(AHB_BASE + 0x00000080))
 #define RCC                 ((RCC_TypeDef *)(AHB_BASE + 0x00001000))
-// #define FLASH_IT            (( *)(AHB_BASE + 0x00002000))
+#define FLASH_IT            ((FLASH_TypeDef *)(AHB_BASE + 0x00002000))
 #define CRC                 ((CRC_TypeDef *)(AHB_BASE + 0x00003000))
 #define ETHERNET            ((ETH_TypeDef *)(AHB_BASE + 0x00008000))
 // #define USB_OTG_FS          (( *)(AHB_BASE + 0x0FFE0000))
 
+// Debug MCU, RM0008 31.16.3
+#define DBGMCU_IDCODE       (*(volatile uint32_t *)0xE0042000)
+#define DBGMCU_CR           (*(volatile uint32_t *)0xE0042004)
+
+#ifdef BOARD_QEMU
+#include "board_qemu.h"
+#endif
+
 #endif /* __STM32F107xC_H */
\ No newline at end of file
@@ -0,0 +1,152 @@
+/**
+ * @file   stm32f107xc.hpp
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  STM32F107xC registers as reg.hpp types: RCC clock enables and
+ *         the GPIO ports.
+ * @ref    RM0008 Reference manual : 8.3 RCC registers, 9.2 GPIO registers
+ *
+ *     using namespace stm32;
+ *
+ *     rcc::APB2ENR::set<rcc::IOPCEN>();
+ *     gpio::PC::CRH::modify(gpio::MODE<13>::is<gpio::OUT_2MHZ>(),
+ *                           gpio::CNF<13>::is<gpio::PUSH_PULL>());
+ *     gpio::PC::BSRR::write(gpio::BS<13>::set(), gpio::BR<14>::set());
+ *
+ * The locations come from the C definitions in stm32f107xc.h, with
+ * BOARD_QEMU they are the register images of board_qemu.h. The field
+ * names are those of the reference manual, the same as the bit macros of
+ * the C drivers (crc.h): do not include those headers in the same file.
+ */
+
+#ifndef __STM32F107xC_HPP
+#define __STM32F107xC_HPP
+
+extern "C" {
+#include "stm32f107xc.h"
+}
+#include "reg.hpp"
+
+namespace stm32 {
+
+namespace rcc {
+
+inline RCC_TypeDef *base() { return RCC; }
+
+struct ahbenr;
+struct apb2enr;
+struct apb1enr;
+
+using AHBENR  = reg::reg<reg::member<RCC_TypeDef, base, &RCC_TypeDef::AHBENR>, ahbenr>;
+using APB2ENR = reg::reg<reg::member<RCC_TypeDef, base, &RCC_TypeDef::APB2ENR>, apb2enr>;
+using APB1ENR = reg::reg<reg::member<RCC_TypeDef, base, &RCC_TypeDef::APB1ENR>, apb1enr>;
+
+// RCC_AHBENR
+using DMA1EN     = reg::field<ahbenr, 0, 1>;
+using DMA2EN     = reg::field<ahbenr, 1, 1>;
+using SRAMEN     = reg::field<ahbenr, 2, 1>;
+using FLITFEN    = reg::field<ahbenr, 4, 1>;
+using CRCEN      = reg::field<ahbenr, 6, 1>;
+using OTGFSEN    = reg::field<ahbenr, 12, 1>;
+using ETHMACEN   = reg::field<ahbenr, 14, 1>;
+using ETHMACTXEN = reg::field<ahbenr, 15, 1>;
+using ETHMACRXEN = reg::field<ahbenr, 16, 1>;
+
+// RCC_APB2ENR
+using AFIOEN     = reg::field<apb2enr, 0, 1>;
+using IOPAEN     = reg::field<apb2enr, 2, 1>;
+using IOPBEN     = reg::field<apb2enr, 3, 1>;
+using IOPCEN     = reg::field<apb2enr, 4, 1>;
+using IOPDEN     = reg::field<apb2enr, 5, 1>;
+using IOPEEN     = reg::field<apb2enr, 6, 1>;
+using ADC1EN     = reg::field<apb2enr, 9, 1>;
+using ADC2EN     = reg::field<apb2enr, 10, 1>;
+using TIM1EN     = reg::field<apb2enr, 11, 1>;
+using SPI1EN     = reg::field<apb2enr, 12, 1>;
+using USART1EN   = reg::field<apb2enr, 14, 1>;
+
+// RCC_APB1ENR
+using TIM2EN     = reg::field<apb1enr, 0, 1>;
+using TIM3EN     = reg::field<apb1enr, 1, 1>;
+using TIM4EN     = reg::field<apb1enr, 2, 1>;
+using TIM5EN     = reg::field<apb1enr, 3, 1>;
+using TIM6EN     = reg::field<apb1enr, 4, 1>;
+using TIM7EN     = reg::field<apb1enr, 5, 1>;
+using WWDGEN     = reg::field<apb1enr, 11, 1>;
+using SPI2EN     = reg::field<apb1enr, 14, 1>;
+using SPI3EN     = reg::field<apb1enr, 15, 1>;
+using USART2EN   = reg::field<apb1enr, 17, 1>;
+using USART3EN   = reg::field<apb1enr, 18, 1>;
+using UART4EN    = reg::field<apb1enr, 19, 1>;
+using UART5EN    = reg::field<apb1enr, 20, 1>;
+using I2C1EN     = reg::field<apb1enr, 21, 1>;
+using I2C2EN     = reg::field<apb1enr, 22, 1>;
+using CAN1EN     = reg::field<apb1enr, 25, 1>;
+using CAN2EN     = reg::field<apb1enr, 26, 1>;
+using BKPEN      = reg::field<apb1enr, 27, 1>;
+using PWREN      = reg::field<apb1enr, 28, 1>;
+using DACEN      = reg::field<apb1enr, 29, 1>;
+
+} // namespace rcc
+
+namespace gpio {
+
+struct crl;
+struct crh;
+struct idr;
+struct odr;
+struct bsrr;
+struct brr;
+
+namespace detail {
+template <bool Low> struct cr { using type = crh; };
+template <> struct cr<true> { using type = crl; };
+} // namespace detail
+
+// GPIOx_CRL / GPIOx_CRH, the register follows from the pin
+template <unsigned Pin>
+using MODE = reg::field<typename detail::cr<(Pin < 8)>::type, (Pin % 8) * 4, 2>;
+template <unsigned Pin>
+using CNF  = reg::field<typename detail::cr<(Pin < 8)>::type, (Pin % 8) * 4 + 2, 2>;
+
+// MODE
+enum : uint32_t { INPUT = 0, OUT_10MHZ = 1, OUT_2MHZ = 2, OUT_50MHZ = 3 };
+// CNF, input
+enum : uint32_t { ANALOG = 0, FLOATING = 1, PULL = 2 };
+// CNF, output
+enum : uint32_t { PUSH_PULL = 0, OPEN_DRAIN = 1, AF_PUSH_PULL = 2, AF_OPEN_DRAIN = 3 };
+
+template <unsigned Pin> using IDR = reg::field<idr, Pin, 1, reg::access::ro>;
+template <unsigned Pin> using ODR = reg::field<odr, Pin, 1>;
+template <unsigned Pin> using BS  = reg::field<bsrr, Pin, 1, reg::access::wo>;
+template <unsigned Pin> using BR  = reg::field<bsrr, Pin + 16, 1, reg::access::wo>;
+template <unsigned Pin> using BRR = reg::field<brr, Pin, 1, reg::access::wo>;
+
+template <GPIO_TypeDef *(*Base)()>
+struct port
+{
+    using CRL  = reg::reg<reg::member<GPIO_TypeDef, Base, &GPIO_TypeDef::CRL>, crl>;
+    using CRH  = reg::reg<reg::member<GPIO_TypeDef, Base, &GPIO_TypeDef::CRH>, crh>;
+    using IDR  = reg::reg<reg::member<GPIO_TypeDef, Base, &GPIO_TypeDef::IDR>, idr>;
+    using ODR  = reg::reg<reg::member<GPIO_TypeDef, Base, &GPIO_TypeDef::ODR>, odr>;
+    using BSRR = reg::reg<reg::member<GPIO_TypeDef, Base, &GPIO_TypeDef::BSRR>, bsrr>;
+    using BRR  = reg::reg<reg::member<GPIO_TypeDef, Base, &GPIO_TypeDef::BRR>, brr>;
+};
+
+inline GPIO_TypeDef *porta() { return PORTA; }
+inline GPIO_TypeDef *portb() { return PORTB; }
+inline GPIO_TypeDef *portc() { return PORTC; }
+inline GPIO_TypeDef *portd() { return PORTD; }
+inline GPIO_TypeDef *porte() { return PORTE; }
+
+using PA = port<porta>;
+using PB = port<portb>;
+using PC = port<portc>;
+using PD = port<portd>;
+using PE = port<porte>;
+
+} // namespace gpio
+
+} // namespace stm32
+
+#endif /* __STM32F107xC_HPP */
@@ -0,0 +1,257 @@
+/**
+ * @file   string_cm3.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  memcpy / memmove / memset tuned for Cortex-M3.
+ *
+ * These replace the byte-loop versions of newlib-nano at link time: an
+ * object that defines the symbol keeps the linker from pulling the libc
+ * archive member. The __aeabi_* entry points the compiler may emit are
+ * routed here too.
+ *
+ *  - Blocks with an aligned source and destination are moved with
+ *    8-register LDM/STM bursts, 32 bytes per iteration.
+ *  - A misaligned source uses single unaligned LDRs, which the M3 does
+ *    in hardware, and aligned STMs. CCR.UNALIGN_TRP must stay cleared.
+ *  - Heads are copied byte-wise until the destination is aligned, tails
+ *    word-wise and then byte-wise.
+ *
+ * NOTE: `used` keeps LTO from dropping the definitions before the code
+ *       generator emits its own calls to them.
+ */
+
+#include <string.h>
+
+/* Naked functions take their arguments in r0-r3 by the AAPCS. */
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+__attribute__((naked, used)) void *memcpy(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile (
+        "mov    ip, r0                  \n"     // return value
+        "cmp    r2, #16                 \n"
+        "blo    .Lmc_small              \n"
+        "push   {r4-r10}                \n"
+        // copy bytes until dst is word aligned
+        "ands   r3, r0, #3              \n"
+        "beq    1f                      \n"
+        "rsb    r3, r3, #4              \n"
+        "sub    r2, r2, r3              \n"
+        "0:                             \n"
+        "ldrb   r4, [r1], #1            \n"
+        "strb   r4, [r0], #1            \n"
+        "subs   r3, r3, #1              \n"
+        "bne    0b                      \n"
+        "1:                             \n"
+        "tst    r1, #3                  \n"
+        "bne    .Lmc_unaligned          \n"
+        // both aligned: 32 bytes per LDM/STM pair
+        "subs   r2, r2, #32             \n"
+        "blo    3f                      \n"
+        "2:                             \n"
+        "ldmia  r1!, {r3-r10}           \n"
+        "stmia  r0!, {r3-r10}           \n"
+        "subs   r2, r2, #32             \n"
+        "bhs    2b                      \n"
+        "3:                             \n"
+        "adds   r2, r2, #32             \n"
+        "b      .Lmc_tail               \n"
+        // dst aligned, src not: unaligned LDR, aligned STM
+        ".Lmc_unaligned:                \n"
+        "subs   r2, r2, #16             \n"
+        "blo    5f                      \n"
+        "4:                             \n"
+        "ldr    r3, [r1], #4            \n"
+        "ldr    r4, [r1], #4            \n"
+        "ldr    r5, [r1], #4            \n"
+        "ldr    r6, [r1], #4            \n"
+        "stmia  r0!, {r3-r6}            \n"
+        "subs   r2, r2, #16             \n"
+        "bhs    4b                      \n"
+        "5:                             \n"
+        "adds   r2, r2, #16             \n"
+        ".Lmc_tail:                     \n"
+        "pop    {r4-r10}                \n"
+        // fewer than 32 bytes left
+        ".Lmc_small:                    \n"
+        "subs   r2, r2, #4              \n"
+        "blo    7f                      \n"
+        "6:                             \n"
+        "ldr    r3, [r1], #4            \n"
+        "str    r3, [r0], #4            \n"
+        "subs   r2, r2, #4              \n"
+        "bhs    6b                      \n"
+        "7:                             \n"
+        "adds   r2, r2, #4              \n"
+        "beq    9f                      \n"
+        "8:                             \n"
+        "ldrb   r3, [r1], #1            \n"
+        "strb   r3, [r0], #1            \n"
+        "subs   r2, r2, #1              \n"
+        "bne    8b                      \n"
+        "9:                             \n"
+        "mov    r0, ip                  \n"
+        "bx     lr                      \n"
+    );
+}
+
+/**
+ * @brief Forward copies are safe whenever dst is below src or the
+ *        buffers do not overlap, otherwise copy from the end.
+ */
+__attribute__((naked, used)) void *memmove(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile (
+        "cmp    r0, r1                  \n"
+        "bls    memcpy                  \n"
+        "add    r3, r1, r2              \n"
+        "cmp    r0, r3                  \n"
+        "bhs    memcpy                  \n"
+        "mov    ip, r0                  \n"
+        "push   {r4-r7}                 \n"
+        "add    r0, r0, r2              \n"
+        "add    r1, r1, r2              \n"
+        "cmp    r2, #16                 \n"
+        "blo    3f                      \n"
+        // copy bytes until the end of dst is word aligned
+        "ands   r3, r0, #3              \n"
+        "beq    1f                      \n"
+        "sub    r2, r2, r3              \n"
+        "0:                             \n"
+        "ldrb   r4, [r1, #-1]!          \n"
+        "strb   r4, [r0, #-1]!          \n"
+        "subs   r3, r3, #1              \n"
+        "bne    0b                      \n"
+        "1:                             \n"
+        "subs   r2, r2, #16             \n"
+        "blo    2f                      \n"
+        "10:                            \n"
+        "ldr    r7, [r1, #-4]!          \n"
+        "ldr    r6, [r1, #-4]!          \n"
+        "ldr    r5, [r1, #-4]!          \n"
+        "ldr    r4, [r1, #-4]!          \n"
+        "stmdb  r0!, {r4-r7}            \n"
+        "subs   r2, r2, #16             \n"
+        "bhs    10b                     \n"
+        "2:                             \n"
+        "adds   r2, r2, #16             \n"
+        "3:                             \n"
+        "cbz    r2, 5f                  \n"
+        "4:                             \n"
+        "ldrb   r4, [r1, #-1]!          \n"
+        "strb   r4, [r0, #-1]!          \n"
+        "subs   r2, r2, #1              \n"
+        "bne    4b                      \n"
+        "5:                             \n"
+        "pop    {r4-r7}                 \n"
+        "mov    r0, ip                  \n"
+        "bx     lr                      \n"
+    );
+}
+
+__attribute__((naked, used)) void *memset(void *dst, int c, size_t n)
+{
+    __asm__ volatile (
+        "mov    ip, r0                  \n"     // return value
+        "and    r1, r1, #0xFF           \n"
+        "orr    r1, r1, r1, lsl #8      \n"
+        "orr    r1, r1, r1, lsl #16     \n"
+        "cmp    r2, #16                 \n"
+        "blo    .Lms_small              \n"
+        // store bytes until dst is word aligned
+        "ands   r3, r0, #3              \n"
+        "beq    1f                      \n"
+        "rsb    r3, r3, #4              \n"
+        "sub    r2, r2, r3              \n"
+        "0:                             \n"
+        "strb   r1, [r0], #1            \n"
+        "subs   r3, r3, #1              \n"
+        "bne    0b                      \n"
+        "1:                             \n"
+        "push   {r4-r5}                 \n"
+        "mov    r3, r1                  \n"
+        "mov    r4, r1                  \n"
+        "mov    r5, r1                  \n"
+        "subs   r2, r2, #32             \n"
+        "blo    3f                      \n"
+        "2:                             \n"
+        "stmia  r0!, {r1, r3-r5}        \n"
+        "stmia  r0!, {r1, r3-r5}        \n"
+        "subs   r2, r2, #32             \n"
+        "bhs    2b                      \n"
+        "3:                             \n"
+        "adds   r2, r2, #32             \n"
+        "pop    {r4-r5}                 \n"
+        // fewer than 32 bytes left
+        ".Lms_small:                    \n"
+        "subs   r2, r2, #4              \n"
+        "blo    5f                      \n"
+        "4:                             \n"
+        "str    r1, [r0], #4            \n"
+        "subs   r2, r2, #4              \n"
+        "bhs    4b                      \n"
+        "5:                             \n"
+        "adds   r2, r2, #4              \n"
+        "beq    7f                      \n"
+        "6:                             \n"
+        "strb   r1, [r0], #1            \n"
+        "subs   r2, r2, #1              \n"
+        "bne    6b                      \n"
+        "7:                             \n"
+        "mov    r0, ip                  \n"
+        "bx     lr                      \n"
+    );
+}
+
+/**
+ * ARM run-time ABI entry points (RTABI 4.3.4). __aeabi_memset takes the
+ * length before the fill value.
+ */
+__attribute__((naked, used)) void __aeabi_memcpy(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile ("b    memcpy");
+}
+
+__attribute__((naked, used)) void __aeabi_memcpy4(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile ("b    memcpy");
+}
+
+__attribute__((naked, used)) void __aeabi_memcpy8(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile ("b    memcpy");
+}
+
+__attribute__((naked, used)) void __aeabi_memmove(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile ("b    memmove");
+}
+
+__attribute__((naked, used)) void __aeabi_memmove4(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile ("b    memmove");
+}
+
+__attribute__((naked, used)) void __aeabi_memmove8(void *dst, const void *src, size_t n)
+{
+    __asm__ volatile ("b    memmove");
+}
+
+__attribute__((naked, used)) void __aeabi_memset(void *dst, size_t n, int c)
+{
+    __asm__ volatile (
+        "mov    r3, r1                  \n"
+        "mov    r1, r2                  \n"
+        "mov    r2, r3                  \n"
+        "b      memset                  \n"
+    );
+}
+
+__attribute__((naked, used)) void __aeabi_memclr(void *dst, size_t n)
+{
+    __asm__ volatile (
+        "mov    r2, r1                  \n"
+        "movs   r1, #0                  \n"
+        "b      memset                  \n"
+    );
+}
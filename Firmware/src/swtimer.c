@@ -0,0 +1,249 @@
+/**
+ * @file   swtimer.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Software timers on a hierarchical timing wheel.
+ */
+
+#include "core_cm3.h"
+#include "swtimer.h"
+
+// SYST_CSR
+#define SYST_ENABLE     (1 << 0)
+#define SYST_TICKINT    (1 << 1)
+#define SYST_CLKSOURCE  (1 << 2)
+
+#define SLOT_MASK       (SWTIMER_SLOTS - 1)
+
+static swtimer_t *wheel[SWTIMER_LEVELS][SWTIMER_SLOTS];
+static uint32_t wheel_now;              /* next tick to process */
+static volatile uint32_t ticks;         /* ticks counted by the interrupt */
+static swtimer_stats_t stats;
+
+static inline void timer_link(swtimer_t *t, swtimer_t **slot)
+{
+    t->next = *slot;
+    if (*slot)
+        (*slot)->pprev = &t->next;
+    *slot = t;
+    t->pprev = slot;
+}
+
+static inline void timer_unlink(swtimer_t *t)
+{
+    *t->pprev = t->next;
+    if (t->next)
+        t->next->pprev = t->pprev;
+    t->pprev = 0;
+}
+
+/**
+ * @brief Put a timer into the slot of its expiry tick, on the finest
+ *        level that reaches it. Expired timers go to the next tick.
+ */
+static void wheel_add(swtimer_t *t)
+{
+    uint32_t expires = t->expires;
+    uint32_t delta = expires - wheel_now;
+    int level = 0;
+
+    if ((int32_t) delta < 0) {
+        expires = wheel_now;
+    } else {
+        if (delta > SWTIMER_MAX_DELAY) {
+            // re-inserted by the cascade until it is in reach
+            delta = SWTIMER_MAX_DELAY;
+            expires = wheel_now + delta;
+        }
+        while (delta >> ((level + 1) * SWTIMER_BITS))
+            level++;
+    }
+    timer_link(t, &wheel[level][(expires >> (level * SWTIMER_BITS)) & SLOT_MASK]);
+}
+
+/**
+ * @brief Move the timers of one slot down the wheel.
+ * @return the slot index, 0 means the level above is due as well.
+ */
+static uint32_t wheel_cascade(int level, uint32_t index)
+{
+    swtimer_t *t = wheel[level][index];
+
+    wheel[level][index] = 0;
+    while (t) {
+        swtimer_t *next = t->next;
+        wheel_add(t);
+        t = next;
+    }
+    return index;
+}
+
+/**
+ * @brief Largest power of 2 within the slack, a common grid for every
+ *        timer with that much slack.
+ */
+static inline uint32_t timer_coalesce(uint32_t due, uint32_t slack)
+{
+    if (!slack)
+        return due;
+    if (slack > SWTIMER_MAX_DELAY)
+        slack = SWTIMER_MAX_DELAY;
+
+    uint32_t grid = 1UL << (31 - __builtin_clz(slack + 1));
+    return (due + grid - 1) & ~(grid - 1);
+}
+
+static void timer_arm(swtimer_t *t)
+{
+    t->expires = timer_coalesce(t->due, t->slack);
+    wheel_add(t);
+}
+
+/**
+ * @brief Process tick wheel_now: cascade on a wrap, then run the slot.
+ */
+static int wheel_run(void)
+{
+    uint32_t index = wheel_now & SLOT_MASK;
+    int ran = 0;
+
+    if (!index) {
+        for (int level = 1; level < SWTIMER_LEVELS; ++level)
+            if (wheel_cascade(level, (wheel_now >> (level * SWTIMER_BITS)) & SLOT_MASK))
+                break;
+    }
+
+    // detach the slot, callbacks may stop the timers still on it
+    swtimer_t *expired = wheel[0][index];
+    wheel[0][index] = 0;
+    if (expired)
+        expired->pprev = &expired;
+    wheel_now++;
+
+    while (expired) {
+        swtimer_t *t = expired;
+
+        timer_unlink(t);
+        if (t->period) {
+            t->due += t->period;
+            timer_arm(t);
+        }
+        t->fn(t->arg);
+        ran++;
+    }
+
+    if (ran) {
+        stats.expired += ran;
+        stats.wakeups++;
+    }
+    return ran;
+}
+
+void swtimer_init(void)
+{
+    for (int level = 0; level < SWTIMER_LEVELS; ++level)
+        for (int i = 0; i < SWTIMER_SLOTS; ++i)
+            wheel[level][i] = 0;
+    wheel_now = ticks;
+    stats.expired = 0;
+    stats.wakeups = 0;
+}
+
+#ifndef BOARD_QEMU
+/**
+ * @brief Tick from SysTick at SWTIMER_HZ. Under QEMU SysTick is the
+ *        harness clock, call swtimer_tick() from elsewhere.
+ */
+void swtimer_systick_start(uint32_t core_clock_hz)
+{
+    SYST_RVR = core_clock_hz / SWTIMER_HZ - 1;
+    SYST_CVR = 0;
+    SYST_CSR = SYST_CLKSOURCE | SYST_TICKINT | SYST_ENABLE;
+}
+
+void SysTick_Handler(void)
+{
+    swtimer_tick();
+}
+#endif
+
+/**
+ * @brief Count one tick, the only call allowed from an interrupt.
+ */
+void swtimer_tick(void)
+{
+    ticks++;
+}
+
+uint32_t swtimer_now(void)
+{
+    return ticks;
+}
+
+void swtimer_setup(swtimer_t *t, void (*fn)(void *arg), void *arg)
+{
+    t->pprev = 0;
+    t->fn = fn;
+    t->arg = arg;
+}
+
+/**
+ * @brief (Re)start a timer `delay` ticks from now, delay < 2^31. A timer
+ *        that is already due runs on the next tick.
+ * @param period 0 for a one-shot timer, otherwise the reload, which
+ *        does not drift with late dispatching.
+ * @param slack  ticks the expiry may be late, for coalescing. Less than
+ *        the period, so that each expiry stays ahead of the last one.
+ */
+void swtimer_start(swtimer_t *t, uint32_t delay, uint32_t period, uint32_t slack)
+{
+    if (t->pprev)
+        timer_unlink(t);
+    t->due = ticks + delay;
+    t->period = period;
+    t->slack = (period && slack >= period) ? period - 1 : slack;
+    timer_arm(t);
+}
+
+void swtimer_stop(swtimer_t *t)
+{
+    if (t->pprev)
+        timer_unlink(t);
+}
+
+/**
+ * @brief Ticks until swtimer_poll() has work: the next occupied slot on
+ *        the finest level, or the next cascade. The idle loop may sleep
+ *        that long.
+ */
+uint32_t swtimer_next(void)
+{
+    uint32_t t = wheel_now;
+
+    while (!wheel[0][t & SLOT_MASK] && ((t + 1) & SLOT_MASK))
+        t++;
+    if (!wheel[0][t & SLOT_MASK])
+        t++;                                // the cascade at the wrap
+
+    uint32_t delta = t - ticks;
+    return (int32_t) delta < 0 ? 0 : delta;
+}
+
+/**
+ * @brief Catch the wheel up with the tick count, run what expired.
+ * @return number of callbacks run.
+ */
+int swtimer_poll(void)
+{
+    uint32_t now = ticks;
+    int ran = 0;
+
+    while ((int32_t) (now - wheel_now) >= 0)
+        ran += wheel_run();
+    return ran;
+}
+
+void swtimer_stats(swtimer_stats_t *s)
+{
+    *s = stats;
+}
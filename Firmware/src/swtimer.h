@@ -0,0 +1,83 @@
+/**
+ * @file   swtimer.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Software timers on a hierarchical timing wheel.
+ *
+ * One hardware tick (SysTick, SWTIMER_HZ) drives any number of one-shot
+ * and periodic timers. The wheel has 4 levels of 64 slots, a timer sits
+ * in the slot of its expiry tick on the finest level that reaches it and
+ * moves down a level each time the level below wraps around. Start and
+ * stop are O(1), the timers are linked into the slots in place.
+ *
+ * The tick interrupt only counts. Callbacks run from swtimer_poll() in
+ * the main loop, so they may take their time and start or stop timers,
+ * themselves included. swtimer_start(), swtimer_stop() and swtimer_poll()
+ * must not be called from interrupts.
+ *
+ * A timer started with slack may expire up to `slack` ticks late. Its
+ * expiry is rounded up to a multiple of the largest power of 2 within
+ * the slack, so timeouts that need not be exact fall on common ticks
+ * and are handled in one wake-up.
+ */
+
+#ifndef __SWTIMER_H
+#define __SWTIMER_H
+
+#include <stdint.h>
+
+#ifndef SWTIMER_HZ
+#define SWTIMER_HZ          1000
+#endif
+
+#define SWTIMER_LEVELS      4
+#define SWTIMER_BITS        6
+#define SWTIMER_SLOTS       (1 << SWTIMER_BITS)
+
+/* Longest delay the wheel holds directly, longer ones are re-inserted. */
+#define SWTIMER_MAX_DELAY   ((1UL << (SWTIMER_LEVELS * SWTIMER_BITS)) - 1)
+
+#define SWTIMER_MS(ms)      ((uint32_t) ((uint64_t) (ms) * SWTIMER_HZ / 1000))
+
+typedef struct swtimer swtimer_t;
+
+struct swtimer
+{
+    swtimer_t  *next;
+    swtimer_t **pprev;          /* NULL when not running */
+    uint32_t    expires;        /* tick the wheel fires on */
+    uint32_t    due;            /* nominal expiry, before slack */
+    uint32_t    period;         /* 0: one-shot */
+    uint32_t    slack;
+    void      (*fn)(void *arg);
+    void       *arg;
+};
+
+typedef struct
+{
+    uint32_t expired;           /* callbacks run */
+    uint32_t wakeups;           /* ticks that ran at least one */
+} swtimer_stats_t;
+
+void swtimer_init(void);
+#ifndef BOARD_QEMU
+void swtimer_systick_start(uint32_t core_clock_hz);
+#endif
+void swtimer_tick(void);
+
+void swtimer_setup(swtimer_t *t, void (*fn)(void *arg), void *arg);
+void swtimer_start(swtimer_t *t, uint32_t delay, uint32_t period, uint32_t slack);
+void swtimer_stop(swtimer_t *t);
+
+static inline int swtimer_running(const swtimer_t *t)
+{
+    return t->pprev != 0;
+}
+
+uint32_t swtimer_now(void);
+uint32_t swtimer_next(void);
+int      swtimer_poll(void);
+
+void swtimer_stats(swtimer_stats_t *stats);
+
+#endif /* __SWTIMER_H */
@@ -0,0 +1,132 @@
+/**
+ * @file   tlm.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Typed telemetry records and commands.
+ */
+
+#include <string.h>
+#include "tlm.h"
+
+static uint32_t tlm_size(char type)
+{
+    switch (type) {
+    case TLM_U8:
+    case TLM_I8:
+        return 1;
+    case TLM_U16:
+    case TLM_I16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/* Append a string with its terminator, 0 if it does not fit. */
+static uint32_t tlm_put(uint8_t *buf, uint32_t at, uint32_t size, const char *s)
+{
+    uint32_t n = strlen(s) + 1;
+
+    if (at + n > size)
+        return 0;
+    memcpy(buf + at, s, n);
+    return at + n;
+}
+
+/**
+ * @brief Pack the fields of `src`, a struct of the record's type.
+ * @return packet length, 0 if it does not fit in `size`.
+ */
+uint32_t tlm_encode(const tlm_record_t *r, const void *src, uint8_t *buf, uint32_t size)
+{
+    uint32_t at = 2;
+
+    if (size < 2)
+        return 0;
+    buf[0] = TLM_RECORD_KIND;
+    buf[1] = r->id;
+    for (uint32_t i = 0; i < r->count; ++i) {
+        const tlm_field_t *f = &r->fields[i];
+        uint32_t n = tlm_size(f->type);
+
+        if (at + n > size)
+            return 0;
+        // the core is little endian, the fields are copied as they are
+        memcpy(buf + at, (const uint8_t *) src + f->offset, n);
+        at += n;
+    }
+    return at;
+}
+
+/**
+ * @brief Schema packet of the record.
+ * @return packet length, 0 if it does not fit in `size`.
+ */
+uint32_t tlm_describe(const tlm_record_t *r, uint8_t *buf, uint32_t size)
+{
+    uint32_t at;
+
+    if (size < 2)
+        return 0;
+    buf[0] = TLM_SCHEMA_KIND;
+    buf[1] = r->id;
+    if (!(at = tlm_put(buf, 2, size, r->name)))
+        return 0;
+
+    if (at + r->count + 1 > size)
+        return 0;
+    for (uint32_t i = 0; i < r->count; ++i)
+        buf[at++] = r->fields[i].type;
+    buf[at++] = 0;
+
+    for (uint32_t i = 0; i < r->count; ++i) {
+        if (!(at = tlm_put(buf, at, size, r->fields[i].name)))
+            return 0;
+        buf[at - 1] = ',';
+    }
+    if (r->count)
+        buf[at - 1] = 0;
+    else if (at < size)
+        buf[at++] = 0;
+    else
+        return 0;
+    return at;
+}
+
+/**
+ * @return a link_send() code, or TLM_ERROR if the record is over LINK_MTU.
+ */
+int tlm_send(link_t *l, const tlm_record_t *r, const void *src)
+{
+    uint8_t buf[LINK_MTU];
+    uint32_t n = tlm_encode(r, src, buf, sizeof(buf));
+
+    return n ? link_send(l, buf, n) : TLM_ERROR;
+}
+
+int tlm_send_schema(link_t *l, const tlm_record_t *r)
+{
+    uint8_t buf[LINK_MTU];
+    uint32_t n = tlm_describe(r, buf, sizeof(buf));
+
+    return n ? link_send(l, buf, n) : TLM_ERROR;
+}
+
+/**
+ * @brief Run the command of a received packet, from the link's receive
+ *        callback.
+ * @return TLM_ERROR if it is no command or not in `table`.
+ */
+int tlm_command(const tlm_command_t *table, uint32_t count,
+                const uint8_t *data, uint32_t len)
+{
+    if (len < 2 || data[0] != TLM_COMMAND_KIND)
+        return TLM_ERROR;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (table[i].id == data[1]) {
+            table[i].fn(data + 2, len - 2);
+            return TLM_OK;
+        }
+    }
+    return TLM_ERROR;
+}
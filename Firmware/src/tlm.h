@@ -0,0 +1,92 @@
+/**
+ * @file   tlm.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Typed telemetry records and commands, packed into link packets.
+ *
+ *     typedef struct
+ *     {
+ *         uint32_t tick;
+ *         int16_t  temp;
+ *         float    rpm;
+ *     } status_t;
+ *
+ *     static const tlm_field_t status_fields[] = {
+ *         TLM_FIELD(status_t, tick, TLM_U32),
+ *         TLM_FIELD(status_t, temp, TLM_I16),
+ *         TLM_FIELD(status_t, rpm,  TLM_F32),
+ *     };
+ *     static const tlm_record_t status_rec = TLM_RECORD(1, "status", status_fields);
+ *
+ *     tlm_send_schema(&host, &status_rec);     // once, the host learns it
+ *     tlm_send(&host, &status_rec, &status);   // 2 + 10 bytes
+ *
+ * A schema is a table in flash that says where each field is in the C
+ * struct. The packet holds the fields in table order, packed without
+ * padding, little endian, behind a kind byte and the record ID. The type
+ * codes are those of Python's struct module, so the schema packet gives
+ * the host decoder (tools/linkdecode.py) everything it needs:
+ *
+ *     TLM_RECORD  | id | fields
+ *     TLM_SCHEMA  | id | name \0 type codes \0 field,field,... \0
+ *     TLM_COMMAND | id | arguments            (host to board)
+ *
+ * Nothing is allocated, packets are built on the stack.
+ */
+
+#ifndef __TLM_H
+#define __TLM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "link.h"
+
+// packet kinds
+#define TLM_RECORD_KIND     0x01
+#define TLM_SCHEMA_KIND     0x02
+#define TLM_COMMAND_KIND    0x03
+
+// field types, Python struct codes
+#define TLM_U8              'B'
+#define TLM_I8              'b'
+#define TLM_U16             'H'
+#define TLM_I16             'h'
+#define TLM_U32             'I'
+#define TLM_I32             'i'
+#define TLM_F32             'f'
+
+#define TLM_OK              0
+#define TLM_ERROR           (-1)            /* too long, unknown command */
+
+typedef struct
+{
+    const char *name;
+    uint16_t    offset;                     /* in the C struct */
+    char        type;
+} tlm_field_t;
+
+typedef struct
+{
+    const char        *name;
+    const tlm_field_t *fields;
+    uint8_t            count;
+    uint8_t            id;
+} tlm_record_t;
+
+#define TLM_FIELD(struct_t, member, type)   { #member, offsetof(struct_t, member), type }
+#define TLM_RECORD(id, name, fields)        { name, fields, sizeof(fields) / sizeof(fields[0]), id }
+
+typedef struct
+{
+    uint8_t id;
+    void  (*fn)(const uint8_t *args, uint32_t len);
+} tlm_command_t;
+
+uint32_t tlm_encode(const tlm_record_t *r, const void *src, uint8_t *buf, uint32_t size);
+uint32_t tlm_describe(const tlm_record_t *r, uint8_t *buf, uint32_t size);
+int      tlm_send(link_t *l, const tlm_record_t *r, const void *src);
+int      tlm_send_schema(link_t *l, const tlm_record_t *r);
+int      tlm_command(const tlm_command_t *table, uint32_t count,
+                     const uint8_t *data, uint32_t len);
+
+#endif /* __TLM_H */
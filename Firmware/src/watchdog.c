@@ -0,0 +1,275 @@
+/**
+ * @file   watchdog.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Watchdog supervisor.
+ */
+
+#include "core_cm3.h"
+#include "stm32f107xc.h"
+#include "compiler.h"
+#include "swtimer.h"
+#include "watchdog.h"
+
+// RCC_APB1ENR
+#define WWDGEN              11
+
+// RCC_CSR
+#define RCC_CSR_RMVF        (1UL << 24)
+#define RCC_CSR_PINRSTF     (1UL << 26)
+#define RCC_CSR_PORRSTF     (1UL << 27)
+#define RCC_CSR_SFTRSTF     (1UL << 28)
+#define RCC_CSR_IWDGRSTF    (1UL << 29)
+#define RCC_CSR_WWDGRSTF    (1UL << 30)
+#define RCC_CSR_LPWRRSTF    (1UL << 31)
+
+// IWDG_KR, IWDG_PR, IWDG_SR
+#define IWDG_KEY_RELOAD     0xAAAA
+#define IWDG_KEY_UNLOCK     0x5555
+#define IWDG_KEY_START      0xCCCC
+#define IWDG_PR_DIV64       4
+#define IWDG_SR_PVU         (1 << 0)
+#define IWDG_SR_RVU         (1 << 1)
+#define IWDG_RLR_MAX        0x0FFF
+#define LSI_HZ              40000       /* nominal, 30 to 60 kHz */
+
+// WWDG_CR, WWDG_CFR
+#define WWDG_T_MAX          0x7F        /* resets on the 0x40 -> 0x3F step */
+#define WWDG_T_EWI          0x40
+#define WWDG_CR_WDGA        (1 << 7)
+#define WWDG_CFR_WDGTB_8    (3 << 7)    /* PCLK1 / 4096 / 8 */
+#define WWDG_CFR_EWI        (1 << 9)
+#define WWDG_IRQn           0
+
+// DBGMCU_CR
+#define DBG_IWDG_STOP       (1 << 8)
+#define DBG_WWDG_STOP       (1 << 9)
+
+#define SAVED_MAGIC         0x57444721
+
+typedef struct
+{
+    uint32_t magic;
+    int32_t  activity;
+    uint32_t overdue;
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t check;
+} saved_t;
+
+/* Survives the watchdog reset, see .noinit in sections.ld. */
+static saved_t saved __attribute__((section(".noinit")));
+
+static wdg_report_t report;
+
+static uint32_t deadline[WDG_MAX_ACTIVITIES];
+static volatile uint32_t last[WDG_MAX_ACTIVITIES];
+static int activities;
+static int stalled;                     /* once set, never refreshed again */
+static uint32_t stalled_overdue;
+
+static uint32_t saved_check(const saved_t *s)
+{
+    return ~(s->magic ^ (uint32_t) s->activity ^ s->overdue ^ s->pc ^ s->lr);
+}
+
+static void save(int id, uint32_t overdue, uint32_t pc, uint32_t lr)
+{
+    saved.magic = SAVED_MAGIC;
+    saved.activity = id;
+    saved.overdue = overdue;
+    saved.pc = pc;
+    saved.lr = lr;
+    saved.check = saved_check(&saved);
+}
+
+static uint32_t reset_cause(uint32_t csr)
+{
+    // the pin flag is set on every reset, it goes last
+    if (csr & RCC_CSR_LPWRRSTF)
+        return WDG_CAUSE_LOW_POWER;
+    if (csr & RCC_CSR_WWDGRSTF)
+        return WDG_CAUSE_WWDG;
+    if (csr & RCC_CSR_IWDGRSTF)
+        return WDG_CAUSE_IWDG;
+    if (csr & RCC_CSR_SFTRSTF)
+        return WDG_CAUSE_SOFTWARE;
+    if (csr & RCC_CSR_PORRSTF)
+        return WDG_CAUSE_POWER;
+    if (csr & RCC_CSR_PINRSTF)
+        return WDG_CAUSE_PIN;
+    return WDG_CAUSE_UNKNOWN;
+}
+
+/**
+ * @brief Read why the chip was reset and what the supervisor saved
+ *        before, then forget both. Call once, early in main().
+ */
+void wdg_init(void)
+{
+    report.cause = reset_cause(RCC->CSR);
+    RCC->CSR |= RCC_CSR_RMVF;
+
+    report.activity = WDG_NONE;
+    report.overdue = 0;
+    report.pc = 0;
+    report.lr = 0;
+    if ((report.cause == WDG_CAUSE_WWDG || report.cause == WDG_CAUSE_IWDG) &&
+        saved.magic == SAVED_MAGIC && saved.check == saved_check(&saved)) {
+        report.activity = saved.activity;
+        report.overdue = saved.overdue;
+        report.pc = saved.pc;
+        report.lr = saved.lr;
+    }
+    saved.magic = 0;
+
+    activities = 0;
+    stalled = WDG_NONE;
+    stalled_overdue = 0;
+}
+
+const wdg_report_t *wdg_last_reset(void)
+{
+    return &report;
+}
+
+const char *wdg_cause_name(uint32_t cause)
+{
+    static const char *const names[] = {
+        "unknown", "power", "pin", "software", "iwdg", "wwdg", "low-power",
+    };
+
+    return cause < sizeof(names) / sizeof(names[0]) ? names[cause] : names[0];
+}
+
+/**
+ * @brief Add an activity that must check in at least every `deadline`
+ *        ticks. It counts as checked in now.
+ * @return its ID for wdg_checkin(), WDG_NONE when the table is full.
+ */
+int wdg_register(uint32_t deadline_ticks)
+{
+    if (activities == WDG_MAX_ACTIVITIES)
+        return WDG_NONE;
+
+    int id = activities;
+    deadline[id] = deadline_ticks;
+    last[id] = swtimer_now();
+    activities++;
+    return id;
+}
+
+/**
+ * @brief Report an activity alive, callable from any context. IDs that
+ *        were not registered, WDG_NONE among them, are ignored.
+ */
+void wdg_checkin(int id)
+{
+    if (id < 0 || id >= activities)
+        return;
+    last[id] = swtimer_now();
+}
+
+/**
+ * @brief The activity furthest past its deadline.
+ */
+static int wdg_overdue(uint32_t now, uint32_t *overdue)
+{
+    int worst = WDG_NONE;
+
+    *overdue = 0;
+    for (int i = 0; i < activities; ++i) {
+        uint32_t late = now - last[i] - deadline[i];
+        if ((int32_t) late > 0 && late > *overdue) {
+            *overdue = late;
+            worst = i;
+        }
+    }
+    return worst;
+}
+
+/**
+ * @brief Start the IWDG, `iwdg_ms` at the nominal LSI clock, and the WWDG
+ *        with its early wake-up interrupt. Neither can be stopped again.
+ * @return ms within which wdg_poll() must run, the WWDG timeout before
+ *         the early wake-up.
+ */
+uint32_t wdg_start(uint32_t pclk1_hz, uint32_t iwdg_ms)
+{
+    uint32_t reload = (uint64_t) iwdg_ms * LSI_HZ / 64 / 1000;
+
+    if (reload > IWDG_RLR_MAX)
+        reload = IWDG_RLR_MAX;
+    if (!reload)
+        reload = 1;
+
+#ifndef BOARD_QEMU
+    // hold both while a debugger has the core halted
+    DBGMCU_CR |= DBG_IWDG_STOP | DBG_WWDG_STOP;
+#endif
+
+    IWDG->KR = IWDG_KEY_START;
+    IWDG->KR = IWDG_KEY_UNLOCK;
+    IWDG->PR = IWDG_PR_DIV64;
+    IWDG->RLR = reload;
+    while (IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU))
+        ;
+    IWDG->KR = IWDG_KEY_RELOAD;
+
+    // no window: a refresh is never too early
+    RCC->APB1ENR |= (1 << WWDGEN);
+    WWDG->CFR = WWDG_CFR_EWI | WWDG_CFR_WDGTB_8 | WWDG_T_MAX;
+    WWDG->SR = 0;
+    WWDG->CR = WWDG_CR_WDGA | WWDG_T_MAX;
+
+#ifndef BOARD_QEMU
+    NVIC_IPR[WWDG_IRQn] = 0;            // above everything it may have to catch
+    NVIC_ISER0 = 1 << WWDG_IRQn;
+#endif
+
+    return (uint64_t) 4096 * 8 * (WWDG_T_MAX - WWDG_T_EWI) * 1000 / pclk1_hz;
+}
+
+/**
+ * @brief Refresh both watchdogs if every activity is in time. From the
+ *        first miss on they are never refreshed again.
+ * @return the stalled activity, WDG_NONE if all are alive.
+ */
+int wdg_poll(void)
+{
+    if (stalled == WDG_NONE) {
+        stalled = wdg_overdue(swtimer_now(), &stalled_overdue);
+        if (stalled == WDG_NONE) {
+            IWDG->KR = IWDG_KEY_RELOAD;
+            WWDG->CR = WWDG_CR_WDGA | WWDG_T_MAX;
+            return WDG_NONE;
+        }
+        // in case the early wake-up cannot run
+        save(stalled, stalled_overdue, 0, 0);
+    }
+    return stalled;
+}
+
+/**
+ * @brief Save the stalled activity and where the core was for the next
+ *        boot. Runs from the WWDG interrupt, the reset follows within a
+ *        WWDG tick.
+ * @param frame exception stack frame, from WWDG_Handler (EXC_FRAME_TRAMPOLINE).
+ */
+__attribute__((used)) void wdg_early_wakeup(const uint32_t *frame)
+{
+    uint32_t overdue;
+    int id = wdg_overdue(swtimer_now(), &overdue);
+
+    if (id == WDG_NONE) {
+        // stopped by wdg_poll() since, or the main loop itself hangs
+        id = stalled;
+        overdue = stalled_overdue;
+    }
+    save(id, overdue, frame[6], frame[5]);
+    WWDG->SR = 0;
+}
+
+#ifndef BOARD_QEMU
+EXC_FRAME_TRAMPOLINE(WWDG_Handler, wdg_early_wakeup)
+#endif
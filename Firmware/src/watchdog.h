@@ -0,0 +1,69 @@
+/**
+ * @file   watchdog.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Watchdog supervisor: IWDG and WWDG fed only while every
+ *         registered activity is alive.
+ *
+ *     wdg_init();                          // first thing in main()
+ *     adc = wdg_register(SWTIMER_MS(20));
+ *     net = wdg_register(SWTIMER_MS(500));
+ *     wdg_start(pclk1_hz, 1000);
+ *
+ *     // in the ADC interrupt, the network loop, ...
+ *     wdg_checkin(adc);
+ *
+ *     // in the main loop, at least every wdg_start() returned ms
+ *     wdg_poll();
+ *
+ * An activity that has not checked in for longer than its deadline
+ * stops the refresh. The WWDG early wake-up interrupt then saves the
+ * stalled activity and the interrupted PC in RAM that survives the reset
+ * and the WWDG resets the chip a WWDG tick later. If the main loop
+ * itself hangs, wdg_poll() no longer runs and the same happens. The
+ * IWDG runs from the LSI and is the backstop when the WWDG cannot fire,
+ * e.g. with the clocks broken.
+ *
+ * Deadlines are in swtimer ticks (swtimer_now()), SysTick must run.
+ */
+
+#ifndef __WATCHDOG_H
+#define __WATCHDOG_H
+
+#include <stdint.h>
+
+#define WDG_MAX_ACTIVITIES  8
+#define WDG_NONE            (-1)
+
+/* Reset causes, from RCC_CSR. */
+enum {
+    WDG_CAUSE_UNKNOWN = 0,
+    WDG_CAUSE_POWER,            /* power-on or power-down reset */
+    WDG_CAUSE_PIN,              /* NRST pin */
+    WDG_CAUSE_SOFTWARE,         /* SCB_AIRCR.SYSRESETREQ */
+    WDG_CAUSE_IWDG,
+    WDG_CAUSE_WWDG,
+    WDG_CAUSE_LOW_POWER,        /* Stop or Standby entered with nRST_STOP/STDBY */
+};
+
+typedef struct
+{
+    uint32_t cause;             /* WDG_CAUSE_* */
+    int32_t  activity;          /* stalled activity, WDG_NONE if not known */
+    uint32_t overdue;           /* ticks past its deadline */
+    uint32_t pc;                /* interrupted at the WWDG early wake-up, 0 if none */
+    uint32_t lr;
+} wdg_report_t;
+
+void wdg_init(void);
+const wdg_report_t *wdg_last_reset(void);
+const char *wdg_cause_name(uint32_t cause);
+
+int  wdg_register(uint32_t deadline_ticks);
+void wdg_checkin(int id);
+uint32_t wdg_start(uint32_t pclk1_hz, uint32_t iwdg_ms);
+int  wdg_poll(void);
+
+void wdg_early_wakeup(const uint32_t *frame);
+
+#endif /* __WATCHDOG_H */
@@ -6,19 +6,13 @@
  *
  * @brief 
  *      1. Create Vector table
- *      2. Copy .data section to SRAM
+ *      2. Copy .data section to SRAM, or unpack it (LZDATA=1)
  *      3. Init the .bss section to zero in SRAM
  *      4. call main()
  */
 
 #include "../src/core_cm3.h"
 
-#define SRAM_START  0x20000000
-#define SRAM_SIZE   (64 * 1024)
-#define SRAM_END    ((SRAM_START) + (SRAM_SIZE))
-#define STACK_START SRAM_END
-
-
 /* Section address defined in linker script */
 extern uint32_t _etext;
 extern uint32_t _la_data;
@@ -27,6 +21,9 @@ extern uint32_t _edata;
 extern uint32_t _sbss;
 extern uint32_t _ebss;
 extern uint32_t _estack;
+/* Defined by both links of an LZDATA=1 build (--defsym), otherwise
+ * undefined and so at 0: only then is the load image a .data_lz block. */
+extern const uint8_t _lzdata __attribute__((weak));
 
 extern int main(void);
 
@@ -115,9 +112,9 @@ void OTG_FS_Handler         (void) __attribute__((weak, alias("Default_Handler")
  *   DUI0552A_cortex_m3_dgug 2-22
  *   Table 2-16 Properties of the different exception types   
  */
-static void *const vector[] __attribute__((section(".isr_vector"))) = {
+void *const vector[] __attribute__((section(".isr_vector"))) = {
     /* Initial SP value */
-    (void *) STACK_START,   // 0x00000000
+    &_estack,               // 0x00000000
     /* Cortex-M3 processor system handlers */
     Reset_Handler,          // 0x00000004
     NMI_Handler,            // 0x00000008
@@ -205,16 +202,79 @@ static void *const vector[] __attribute__((section(".isr_vector"))) = {
     OTG_FS_Handler,         // 0x0000014C
 };
 
+/* DWT cycles the .data initialisation took, 0 without DWT (QEMU). */
+uint32_t startup_data_cycles;
+/* Flash taken by the compressed load image, 0 if .data was copied. */
+uint32_t startup_data_lz_bytes;
+
 /**
- * @brief Initialize .data section.
+ * @brief Decode an LZ4 block until `size` bytes are written. Runs before
+ *        .data and .bss are set up, so it uses nothing but the stack.
+ * @return bytes of `src` read.
  */
-static void copy_data_section()
+uint32_t lz4_decode(const uint8_t *src, uint8_t *dst, uint32_t size)
+{
+    const uint8_t *start = src;
+    uint8_t *out = dst;
+    uint8_t *end = dst + size;
+
+    while (out < end) {
+        uint32_t token = *src++;
+        uint32_t n = token >> 4;
+        uint32_t b;
+
+        if (n == 15) {
+            do {
+                b = *src++;
+                n += b;
+            } while (b == 255);
+        }
+        while (n-- && out < end)
+            *out++ = *src++;
+        if (out >= end)
+            break;                          // the last sequence has no match
+
+        const uint8_t *from = out - (src[0] | src[1] << 8);
+        src += 2;
+        n = (token & 15) + 4;
+        if (n == 19) {
+            do {
+                b = *src++;
+                n += b;
+            } while (b == 255);
+        }
+        while (n-- && out < end)            // may overlap, byte by byte
+            *out++ = *from++;
+    }
+    return src - start;
+}
+
+/**
+ * @brief Initialize .data section: unpack the load image if it is
+ *        compressed (LZDATA=1), copy it otherwise. A .data_lz block
+ *        (tools/lzdata.py) starts with the length of its LZ4 block, 0
+ *        when .data follows as it is.
+ * @return bytes of the compressed image, 0 if copied.
+ */
+static uint32_t copy_data_section()
 {
     uint8_t *src = (uint8_t *) &_la_data;
     uint8_t *des = (uint8_t *) &_sdata;
+    uint32_t size = (uint8_t *) &_edata - des;
+
+    if (&_lzdata) {
+        uint32_t packed = _la_data;
+        src += 4;
+        if (packed) {
+            lz4_decode(src, des, size);
+            return 4 + packed;
+        }
+    }
+
     while (des < (uint8_t *) &_edata) {
         *des++ = *src++;
     }
+    return 0;
 }
 
 /**
@@ -237,8 +297,13 @@ void Default_Reset_Handler(void)
 {
     SCB_VTOR = (uint32_t) vector;
 
-    copy_data_section();
+    dwt_enable();
+    uint32_t start = dwt_cycles();
+    uint32_t lz_bytes = copy_data_section();
+    uint32_t cycles = dwt_cycles() - start;
     clear_bss_section();
+    startup_data_cycles = cycles;
+    startup_data_lz_bytes = lz_bytes;
     main();
     while (1) ;
 }
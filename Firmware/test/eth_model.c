@@ -0,0 +1,90 @@
+/**
+ * @file   eth_model.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Model of the Ethernet DMA for the tests.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "harness.h"
+#include "eth_model.h"
+
+static uint32_t rx_i, tx_i;
+
+/**
+ * @brief Start at the head of both rings, as the DMA does after eth_init().
+ */
+void eth_model_reset(void)
+{
+    rx_i = 0;
+    tx_i = 0;
+}
+
+/**
+ * @brief Descriptor `i` of the ring at `base`, with the skip length
+ *        the driver set in DMABMR.
+ */
+volatile uint32_t *eth_model_descriptor(uint32_t base, uint32_t i)
+{
+    uint32_t words = 4 + ((qemu_eth.DMABMR >> 2) & 0x1F);
+    return (volatile uint32_t *) base + i * words;
+}
+
+/**
+ * @brief Receive `len` bytes of `frame` into the next RX descriptor.
+ * @param rdes0 Status bits besides the length, FS and LS.
+ * @return The descriptor, handed back to the driver; its RDES2 still
+ *         points at the buffer.
+ */
+volatile uint32_t *eth_model_rx(const uint8_t *frame, uint32_t len, uint32_t rdes0)
+{
+    volatile uint32_t *d = eth_model_descriptor(qemu_eth.DMARDLAR, rx_i);
+
+    CHECK(d[0] & OWN);
+    memcpy((uint8_t *) d[2], frame, len);
+    d[0] = ((len + 4) << 16) | RX_FS_LS | rdes0;
+    rx_i = (d[1] & RER) ? 0 : rx_i + 1;
+    return d;
+}
+
+/**
+ * @brief Send the frame in the next TX descriptor, if the driver queued one.
+ * @param buf Gets the first `size` bytes of it.
+ * @param len Gets its length.
+ * @return The descriptor, handed back to the driver, or 0 if none was queued.
+ */
+volatile uint32_t *eth_model_tx(uint8_t *buf, uint32_t size, uint32_t *len)
+{
+    volatile uint32_t *d = eth_model_descriptor(qemu_eth.DMATDLAR, tx_i);
+
+    if (!(d[0] & OWN))
+        return 0;
+    *len = d[1] & 0x1FFF;
+    memcpy(buf, (uint8_t *) d[2], *len < size ? *len : size);
+    tx_i = (d[0] & TER) ? 0 : tx_i + 1;
+    d[0] &= ~OWN;
+    return d;
+}
+
+uint32_t get16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+void put16(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, v >> 16);
+    put16(p + 2, v);
+}
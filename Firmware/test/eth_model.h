@@ -0,0 +1,37 @@
+/**
+ * @file   eth_model.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Model of the Ethernet DMA for the tests: it plays the hardware's
+ *         side of the descriptor rings in the qemu_eth register image.
+ *
+ *     eth_model_reset();                       // after eth_init()
+ *     d = eth_model_rx(frame, len, 0);         // frame in, RDES0 written
+ *     net_poll();
+ *     while ((d = eth_model_tx(sent, sizeof(sent), &len)))
+ *         ...                                  // a frame went out
+ */
+
+#ifndef __ETH_MODEL_H
+#define __ETH_MODEL_H
+
+#include <stdint.h>
+
+// descriptor bits the model uses
+#define OWN             (1UL << 31)
+#define TER             (1UL << 21)         /* TDES0 */
+#define RER             (1 << 15)           /* RDES1 */
+#define RX_FS_LS        ((1 << 9) | (1 << 8))
+
+void eth_model_reset(void);
+volatile uint32_t *eth_model_descriptor(uint32_t base, uint32_t i);
+volatile uint32_t *eth_model_rx(const uint8_t *frame, uint32_t len, uint32_t rdes0);
+volatile uint32_t *eth_model_tx(uint8_t *buf, uint32_t size, uint32_t *len);
+
+/* Network byte order. */
+uint32_t get16(const uint8_t *p);
+uint32_t get32(const uint8_t *p);
+void put16(uint8_t *p, uint32_t v);
+void put32(uint8_t *p, uint32_t v);
+
+#endif /* __ETH_MODEL_H */
@@ -0,0 +1,146 @@
+/**
+ * @file   harness.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  On-target test and benchmark harness.
+ */
+
+#include "core_cm3.h"
+#include "semihost.h"
+#include "harness.h"
+
+// SYST_CSR
+#define SYST_ENABLE     (1 << 0)
+#define SYST_TICKINT    (1 << 1)
+#define SYST_CLKSOURCE  (1 << 2)
+
+#define SYST_MAX        0x00FFFFFF
+
+static int current_failed;
+
+#ifdef BOARD_QEMU
+static volatile uint32_t systick_wraps;
+#endif
+
+#ifdef BOARD_QEMU
+/**
+ * @brief Extend the 24-bit SysTick to 32 bits.
+ */
+void SysTick_Handler(void)
+{
+    systick_wraps++;
+}
+
+/**
+ * @brief Start SysTick free-running on the processor clock.
+ *
+ * QEMU does not model the DWT cycle counter. SysTick counts virtual
+ * time instead, which is deterministic when QEMU runs with -icount.
+ */
+void harness_init(void)
+{
+    SYST_RVR = SYST_MAX;
+    SYST_CVR = 0;
+    SYST_CSR = SYST_CLKSOURCE | SYST_TICKINT | SYST_ENABLE;
+}
+
+uint32_t harness_cycles(void)
+{
+    uint32_t wraps, count;
+
+    do {
+        wraps = systick_wraps;
+        count = SYST_CVR;
+    } while (wraps != systick_wraps);
+
+    return (wraps << 24) + (SYST_MAX - count);
+}
+#else
+/**
+ * @brief Start the DWT cycle counter.
+ */
+void harness_init(void)
+{
+    dwt_enable();
+    DWT_CYCCNT = 0;
+}
+
+uint32_t harness_cycles(void)
+{
+    return dwt_cycles();
+}
+#endif
+
+void harness_check(int ok, const char *expr, const char *file, int line)
+{
+    if (ok || current_failed)
+        return;
+
+    current_failed = 1;
+    semihost_puts("FAIL ");
+    semihost_puts(file);
+    semihost_putc(':');
+    semihost_put_u32(line);
+    semihost_putc(' ');
+    semihost_puts(expr);
+    semihost_putc('\n');
+}
+
+/**
+ * @brief Run every test case and print a DONE summary.
+ * @return number of failed test cases.
+ */
+int harness_run(const test_case_t *tests, int count)
+{
+    int failed = 0;
+
+    for (int i = 0; i < count; ++i) {
+        current_failed = 0;
+        semihost_puts("TEST  ");
+        semihost_puts(tests[i].name);
+        semihost_putc(' ');
+        tests[i].fn();
+        if (current_failed)
+            failed++;
+        else
+            semihost_puts("PASS\n");
+    }
+
+    semihost_puts("DONE  ");
+    semihost_put_u32(count - failed);
+    semihost_putc(' ');
+    semihost_put_u32(failed);
+    semihost_putc('\n');
+    return failed;
+}
+
+void harness_bench(const char *name, uint32_t iterations, uint32_t cycles)
+{
+    semihost_puts("BENCH ");
+    semihost_puts(name);
+    semihost_putc(' ');
+    semihost_put_u32(iterations);
+    semihost_putc(' ');
+    semihost_put_u32(cycles);
+    semihost_putc(' ');
+    semihost_put_u32(iterations ? cycles / iterations : 0);
+    semihost_putc('\n');
+}
+
+void harness_conf(const char *key, const char *value)
+{
+    semihost_puts("CONF  ");
+    semihost_puts(key);
+    semihost_putc(' ');
+    semihost_puts(value);
+    semihost_putc('\n');
+}
+
+void harness_conf_u32(const char *key, uint32_t value)
+{
+    semihost_puts("CONF  ");
+    semihost_puts(key);
+    semihost_putc(' ');
+    semihost_put_u32(value);
+    semihost_putc('\n');
+}
@@ -0,0 +1,52 @@
+/**
+ * @file   harness.h
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  On-target test and benchmark harness.
+ *
+ * Results are reported via semihosting, one record per line:
+ *
+ *   CONF  <key> <value>
+ *   TEST  <name> PASS
+ *   TEST  <name> FAIL <file>:<line> <expression>
+ *   BENCH <name> <iterations> <cycles> <cycles per iteration>
+ *   DONE  <passed> <failed>
+ */
+
+#ifndef __HARNESS_H
+#define __HARNESS_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    const char *name;
+    void (*fn)(void);
+} test_case_t;
+
+#define TEST_CASE(fn)   { #fn, fn }
+
+#define CHECK(cond)     harness_check((cond), #cond, __FILE__, __LINE__)
+
+/**
+ * Time `iters` executions of `body` and report them as `name`.
+ */
+#define BENCH(name, iters, body)                                    \
+    do {                                                            \
+        uint32_t _start = harness_cycles();                         \
+        for (uint32_t _i = 0; _i < (iters); ++_i) {                 \
+            body;                                                   \
+        }                                                           \
+        harness_bench((name), (iters), harness_cycles() - _start);  \
+    } while (0)
+
+void harness_init(void);
+void harness_check(int ok, const char *expr, const char *file, int line);
+int  harness_run(const test_case_t *tests, int count);
+
+uint32_t harness_cycles(void);
+void harness_bench(const char *name, uint32_t iterations, uint32_t cycles);
+void harness_conf(const char *key, const char *value);
+void harness_conf_u32(const char *key, uint32_t value);
+
+#endif /* __HARNESS_H */
@@ -0,0 +1,155 @@
+/**
+ * @file   test_cpuacct.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  CPU accounting, with the DWT counters moved by hand (qemu_dwt).
+ */
+
+#include "stm32f107xc.h"
+#include "cpuacct.h"
+#include "harness.h"
+
+#define CYC     0
+#define CPI     1
+#define EXC     2
+#define SLEEP   3
+
+/* The core runs for `cycles`, with `cpi` and `exc` of them counted. */
+static void run(uint32_t cycles, uint32_t cpi, uint32_t exc)
+{
+    qemu_dwt[CYC] += cycles;
+    qemu_dwt[CPI] = (qemu_dwt[CPI] + cpi) & 0xFF;
+    qemu_dwt[EXC] = (qemu_dwt[EXC] + exc) & 0xFF;
+}
+
+void test_cpuacct_nesting(void)
+{
+    cpuacct_ctx_t stage, irq;
+    cpuacct_report_t r;
+
+    // start near the wrap of the counters
+    qemu_dwt[CYC] = 0xFFFFFF00;
+    qemu_dwt[CPI] = 250;
+    qemu_dwt[EXC] = 255;
+    cpuacct_init();
+    cpuacct_setup(&stage, "stage", CPUACCT_STAGE);
+    cpuacct_setup(&irq, "irq", CPUACCT_IRQ);
+
+    run(100, 1, 0);                         // other
+    cpuacct_enter(&stage);
+    run(200, 10, 0);
+    run(12, 0, 12);                         // exception entry, in the stage
+    cpuacct_enter(&irq);
+    run(50, 3, 0);
+    cpuacct_exit(&irq);
+    run(10, 0, 10);                         // exception return, in the stage
+    run(300, 20, 0);
+    cpuacct_exit(&stage);
+    run(328, 0, 0);                         // other
+    cpuacct_report(&r);
+
+    CHECK(r.window == 1000);
+    CHECK(cpuacct_contexts()->last.cycles == 428);
+    CHECK(stage.last.cycles == 522);
+    CHECK(irq.last.cycles == 50 && irq.last.cpi == 3 && irq.last.exc == 0);
+    CHECK(stage.last_entries == 1 && irq.last_entries == 1);
+
+    // the stage's 310 cycles after the handler, and the 328 of "other"
+    // at the end, are too long for the 8-bit counters
+    CHECK(stage.last.counted == 212 && stage.last.cpi == 10 && stage.last.exc == 12);
+    CHECK(cpuacct_contexts()->last.counted == 100);
+    CHECK(r.counted == 362 && r.exc == 12 && r.stall == 14);
+    CHECK(r.irq == 50 && r.busy == 1000 && r.load_pm == 1000 && r.irq_pm == 62);
+
+    // the next window starts empty
+    CHECK(stage.total.cycles == 0 && stage.entries == 0);
+    run(10, 0, 0);
+    cpuacct_report(&r);
+    CHECK(r.window == 10 && stage.last.cycles == 0);
+    CHECK(cpuacct_contexts()->last.cycles == 10);
+}
+
+void test_cpuacct_idle(void)
+{
+    cpuacct_ctx_t stage, wait;
+    cpuacct_report_t r;
+
+    cpuacct_init();
+    cpuacct_setup(&stage, "stage", CPUACCT_STAGE);
+    cpuacct_setup(&wait, "wait", CPUACCT_IDLE);
+
+    for (int i = 0; i < 4; ++i) {
+        cpuacct_enter(&stage);
+        run(250, 0, 0);
+        cpuacct_exit(&stage);
+        qemu_dwt[CYC] += 750;               // before cpuacct_idle(), "other"
+        qemu_dwt[SLEEP] = (qemu_dwt[SLEEP] + 200) & 0xFF;
+        cpuacct_idle();
+    }
+    cpuacct_report(&r);
+
+    // no WFI in QEMU, the idle context ran for 0 cycles each time
+    CHECK(r.window == 4000);
+    CHECK(r.idle == 0 && r.load_pm == 1000);
+    CHECK(cpuacct_contexts()->next->last_entries == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        cpuacct_enter(&stage);
+        run(250, 0, 0);
+        cpuacct_exit(&stage);
+        cpuacct_enter(&wait);
+        qemu_dwt[CYC] += 200;
+        qemu_dwt[SLEEP] = (qemu_dwt[SLEEP] + 200) & 0xFF;
+        cpuacct_exit(&wait);
+    }
+    // a sleep too long to count, SLEEPCNT wraps more than once
+    cpuacct_enter(&wait);
+    qemu_dwt[CYC] += 1000;
+    qemu_dwt[SLEEP] = (qemu_dwt[SLEEP] + 1000) & 0xFF;
+    cpuacct_exit(&wait);
+    cpuacct_report(&r);
+
+    CHECK(r.window == 2800 && r.idle == 1800 && r.busy == 1000);
+    CHECK(r.load_pm == 357 && r.irq_pm == 0);
+    CHECK(r.counted == 1800 && r.sleep == 800);
+    CHECK(stage.last.cycles == 1000 && stage.last.counted == 1000);
+    CHECK(wait.last.cycles == 1800 && wait.last.counted == 800 && wait.last.sleep == 800);
+}
+
+void test_cpuacct_misuse(void)
+{
+    cpuacct_ctx_t a, b, deep;
+    cpuacct_stats_t stats;
+    cpuacct_report_t r;
+
+    cpuacct_init();
+    cpuacct_setup(&a, "a", CPUACCT_IRQ);
+    cpuacct_setup(&b, "b", CPUACCT_IRQ);
+    cpuacct_setup(&deep, "deep", CPUACCT_IRQ);
+
+    // exits without an enter, and crossed over
+    cpuacct_exit(&a);
+    cpuacct_enter(&a);
+    cpuacct_enter(&b);
+    cpuacct_exit(&a);
+    cpuacct_exit(&b);
+    cpuacct_stats(&stats);
+    CHECK(stats.mismatches == 3 && stats.overflows == 0);
+
+    // beyond CPUACCT_DEPTH the cycles stay with the deepest context
+    for (int i = 1; i < CPUACCT_DEPTH; ++i)
+        cpuacct_enter(&a);
+    cpuacct_enter(&deep);
+    cpuacct_enter(&deep);
+    run(100, 0, 0);
+    cpuacct_exit(&deep);
+    cpuacct_exit(&deep);
+    for (int i = 1; i < CPUACCT_DEPTH; ++i)
+        cpuacct_exit(&a);
+    cpuacct_report(&r);
+    cpuacct_stats(&stats);
+
+    CHECK(stats.overflows == 2 && stats.mismatches == 3);
+    CHECK(a.last.cycles == 100 && deep.last.cycles == 0);
+    CHECK(r.window == 100 && r.irq == 100);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file   test_defer.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Deferred work queues, dispatched by hand from the main loop.
+ */
+
+#include "defer.h"
+#include "harness.h"
+
+typedef struct
+{
+    defer_work_t work;
+    char         tag;
+    defer_work_t *post;         /* posted by the work function */
+    uint32_t     reposts;       /* times to post itself again */
+} probe_t;
+
+static char order[32];
+static uint32_t order_len;
+
+static void probe_fn(void *arg)
+{
+    probe_t *p = arg;
+
+    if (order_len < sizeof(order) - 1)
+        order[order_len++] = p->tag;
+    if (p->post) {
+        defer_post(p->post);
+        p->post = 0;
+    }
+    if (p->reposts) {
+        p->reposts--;
+        defer_post(&p->work);
+    }
+}
+
+static void probe_setup(probe_t *p, char tag, uint32_t prio)
+{
+    defer_setup(&p->work, probe_fn, p, prio);
+    p->tag = tag;
+    p->post = 0;
+    p->reposts = 0;
+}
+
+static int order_is(const char *s)
+{
+    uint32_t i = 0;
+
+    for (; s[i]; ++i)
+        if (i >= order_len || order[i] != s[i])
+            return 0;
+    return i == order_len;
+}
+
+void test_defer_priority(void)
+{
+    probe_t a, b, c, d, e, hi;
+
+    defer_init(DEFER_MAIN_LOOP);
+    order_len = 0;
+    probe_setup(&a, 'a', 3);
+    probe_setup(&b, 'b', 0);
+    probe_setup(&c, 'c', 2);
+    probe_setup(&d, 'd', 2);
+    probe_setup(&e, 'e', 2);
+    probe_setup(&hi, 'H', 0);
+
+    CHECK(defer_run() == 0);
+
+    // by priority, first come first served within one
+    CHECK(defer_post(&a.work) == DEFER_OK);
+    CHECK(defer_post(&c.work) == DEFER_OK);
+    CHECK(defer_post(&b.work) == DEFER_OK);
+    CHECK(defer_post(&d.work) == DEFER_OK);
+    CHECK(defer_run() == 4);
+    CHECK(order_is("bcda"));
+
+    // work posted while running goes by priority too
+    order_len = 0;
+    c.post = &hi.work;
+    defer_post(&c.work);
+    defer_post(&e.work);
+    defer_post(&a.work);
+    CHECK(defer_run() == 4);
+    CHECK(order_is("cHea"));
+
+    defer_info_t info;
+    defer_info(&info);
+    CHECK(info.dispatches == 2);
+    CHECK(info.depth_max[2] == 2 && info.depth_max[3] == 1);
+}
+
+void test_defer_coalesce(void)
+{
+    probe_t p;
+
+    defer_init(DEFER_MAIN_LOOP);
+    order_len = 0;
+    probe_setup(&p, 'p', 1);
+
+    CHECK(defer_post(&p.work) == DEFER_OK);
+    CHECK(defer_post(&p.work) == DEFER_PENDING);
+    CHECK(defer_post(&p.work) == DEFER_PENDING);
+    CHECK(defer_run() == 1);
+    CHECK(p.work.stats.posts == 3 && p.work.stats.coalesced == 2);
+    CHECK(p.work.stats.runs == 1 && !p.work.pending);
+
+    // posting itself from its own function queues it again
+    p.reposts = 2;
+    defer_post(&p.work);
+    CHECK(defer_run() == 3);
+    CHECK(p.work.stats.runs == 4 && p.work.stats.coalesced == 2);
+    CHECK(defer_run() == 0);
+}
+
+void test_defer_full(void)
+{
+    probe_t p[DEFER_QUEUE_LEN + 1], q;
+
+    defer_init(DEFER_MAIN_LOOP);
+    order_len = 0;
+    for (uint32_t i = 0; i <= DEFER_QUEUE_LEN; ++i)
+        probe_setup(&p[i], 'x', 2);
+
+    for (uint32_t i = 0; i < DEFER_QUEUE_LEN; ++i)
+        CHECK(defer_post(&p[i].work) == DEFER_OK);
+    CHECK(defer_post(&p[DEFER_QUEUE_LEN].work) == DEFER_FULL);
+    CHECK(p[DEFER_QUEUE_LEN].work.stats.dropped == 1);
+    CHECK(!p[DEFER_QUEUE_LEN].work.pending);
+
+    // other priorities are not affected
+    probe_setup(&q, 'y', 0);
+    CHECK(defer_post(&q.work) == DEFER_OK);
+
+    CHECK(defer_run() == DEFER_QUEUE_LEN + 1);
+    CHECK(order[0] == 'y');
+    CHECK(defer_post(&p[DEFER_QUEUE_LEN].work) == DEFER_OK);
+    CHECK(defer_run() == 1);
+
+    defer_info_t info;
+    defer_info(&info);
+    CHECK(info.depth_max[2] == DEFER_QUEUE_LEN);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file   test_dsp.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Checks of the fixed-point DSP kernels.
+ */
+
+#include "dsp.h"
+#include "harness.h"
+
+#define FFT_N   64
+
+void test_dsp_fir_impulse(void)
+{
+    static const q15_t coeffs[5] = { 1000, -2000, 3000, 4000, -5000 };
+    q15_t state[5 - 1 + 8];
+    q15_t in[8] = { INT16_MAX };
+    q15_t out[8];
+    dsp_fir_q15_t fir;
+
+    dsp_fir_q15_init(&fir, 5, coeffs, state);
+    dsp_fir_q15(&fir, in, out, 8);
+
+    // impulse response is the coefficients (times 32767 / 32768)
+    for (int i = 0; i < 5; ++i)
+        CHECK(out[i] == coeffs[i] || out[i] == coeffs[i] - 1);
+    for (int i = 5; i < 8; ++i)
+        CHECK(out[i] == 0);
+}
+
+void test_dsp_biquad_dc_gain(void)
+{
+    // y = x / 2 + y[n-1] / 2: unity DC gain
+    static const q31_t coeffs[5] = { 1 << 30, 0, 0, 1 << 30, 0 };
+    q31_t state[4];
+    q31_t in[64], out[64];
+    dsp_biquad_q31_t bq;
+
+    for (int i = 0; i < 64; ++i)
+        in[i] = 1 << 28;
+    dsp_biquad_q31_init(&bq, 1, coeffs, state, 0);
+    dsp_biquad_q31(&bq, in, out, 64);
+
+    CHECK(out[0] == 1 << 27);
+    CHECK(out[63] > (1 << 28) - 16 && out[63] <= 1 << 28);
+}
+
+/**
+ * @brief A tone in bin 5 must come out of the FFT as a single peak.
+ */
+void test_dsp_fft_tone(void)
+{
+    q15_t buf[2 * FFT_N];
+    q15_t mag[FFT_N];
+    const uint32_t step = DSP_FFT_MAX_N / FFT_N;
+
+    // x[t] = 0.5 * exp(j 2 pi 5 t / N), taken from the twiddle table
+    for (uint32_t t = 0; t < FFT_N; ++t) {
+        uint32_t k = ((FFT_N - 5) * t) % FFT_N * step;
+        if (k < DSP_FFT_MAX_N * 3 / 4) {
+            buf[2 * t] = dsp_twiddle_q15[2 * k] / 2;
+            buf[2 * t + 1] = -dsp_twiddle_q15[2 * k + 1] / 2;
+        } else {
+            // the table stops at 3N/4: W^k = j W^(k - 3N/4)
+            const q15_t *w = &dsp_twiddle_q15[2 * (k - DSP_FFT_MAX_N * 3 / 4)];
+            buf[2 * t] = w[1] / 2;
+            buf[2 * t + 1] = w[0] / 2;
+        }
+    }
+
+    CHECK(dsp_cfft_q15(buf, FFT_N) == 0);
+    dsp_cmplx_mag_q15(buf, mag, FFT_N);
+
+    CHECK(mag[5] > 16384 - 64 && mag[5] < 16384 + 64);
+    for (int i = 0; i < FFT_N; ++i)
+        if (i != 5)
+            CHECK(mag[i] < 64);
+
+    CHECK(dsp_cfft_q15(buf, 32) == -1);
+}
+
+void test_dsp_rms(void)
+{
+    q15_t square[16];
+
+    for (int i = 0; i < 16; ++i)
+        square[i] = (i & 1) ? -8192 : 8192;
+    CHECK(dsp_rms_q15(square, 16) == 8192);
+}
@@ -0,0 +1,208 @@
+/**
+ * @file   test_fwupdate.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  A/B image validation, slot selection and the update writer, on
+ *         the RAM-backed slots and flash controller of board_qemu.c.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "crc.h"
+#include "flash.h"
+#include "image.h"
+#include "fwupdate.h"
+#include "harness.h"
+
+#define BODY_WORDS      300                 /* 1200 bytes, chunks and a tail */
+#define INITIAL_SP      0x20008000
+
+static uint32_t img[(IMAGE_HEADER_SIZE / 4) + BODY_WORDS];
+
+/* An image of `words` linked for `slot`, header and all, into `dst`. */
+static void make_image(uint32_t *dst, uint32_t slot, uint32_t seq, uint32_t words)
+{
+    image_header_t *hdr = (image_header_t *) dst;
+    uint32_t *body = dst + IMAGE_HEADER_SIZE / 4;
+
+    memset(dst, 0xFF, IMAGE_HEADER_SIZE);
+    body[0] = INITIAL_SP;
+    body[1] = IMAGE_VECTORS(slot) + 0x101;  // Reset_Handler, Thumb
+    for (uint32_t i = 2; i < words; ++i)
+        body[i] = i * 0x9E3779B9;
+
+    hdr->magic = IMAGE_MAGIC;
+    hdr->seq = seq;
+    hdr->size = words * 4;
+    hdr->crc = crc32_hw(body, words);
+    hdr->hdr_crc = image_header_crc(hdr);
+}
+
+static image_header_t *slot_header(uint32_t slot)
+{
+    return (image_header_t *) slot;
+}
+
+static void slots_erase(void)
+{
+    memset(qemu_slots, 0xFF, 2 * SLOT_SIZE);
+    memset(&qemu_flash, 0, sizeof(qemu_flash));
+}
+
+void test_image_valid(void)
+{
+    image_header_t *hdr = slot_header(SLOT_A_BASE);
+    uint32_t *body = (uint32_t *) IMAGE_VECTORS(SLOT_A_BASE);
+
+    slots_erase();
+    CHECK(!image_valid(SLOT_A_BASE));
+
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 1, BODY_WORDS);
+    CHECK(image_valid(SLOT_A_BASE));
+
+    hdr->magic ^= 1;
+    CHECK(!image_valid(SLOT_A_BASE));
+    hdr->magic ^= 1;
+
+    // a header bit flip that is not covered by the magic
+    hdr->seq ^= 0x100;
+    CHECK(!image_valid(SLOT_A_BASE));
+    hdr->seq ^= 0x100;
+    CHECK(image_valid(SLOT_A_BASE));
+
+    body[BODY_WORDS - 1] ^= 0x80000000;
+    CHECK(!image_valid(SLOT_A_BASE));
+    body[BODY_WORDS - 1] ^= 0x80000000;
+
+    // linked for the other slot: the reset handler is outside the image
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_B_BASE, 1, BODY_WORDS);
+    CHECK(!image_valid(SLOT_A_BASE));
+
+    // larger than the slot, with a consistent header
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 1, BODY_WORDS);
+    hdr->size = SLOT_SIZE;
+    hdr->hdr_crc = image_header_crc(hdr);
+    CHECK(!image_valid(SLOT_A_BASE));
+}
+
+void test_image_select(void)
+{
+    slots_erase();
+    CHECK(image_select() == 0);
+
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 7, BODY_WORDS);
+    CHECK(image_select() == SLOT_A_BASE);
+
+    make_image((uint32_t *) SLOT_B_BASE, SLOT_B_BASE, 8, BODY_WORDS);
+    CHECK(image_select() == SLOT_B_BASE);
+
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 9, BODY_WORDS);
+    CHECK(image_select() == SLOT_A_BASE);
+
+    // the sequence number wraps, 0 follows 0xFFFFFFFF
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 0xFFFFFFFF, BODY_WORDS);
+    make_image((uint32_t *) SLOT_B_BASE, SLOT_B_BASE, 0, BODY_WORDS);
+    CHECK(image_select() == SLOT_B_BASE);
+
+    // the newer one is broken, the older one boots
+    ((uint32_t *) IMAGE_VECTORS(SLOT_B_BASE))[10] ^= 1;
+    CHECK(image_select() == SLOT_A_BASE);
+
+    slot_header(SLOT_A_BASE)->magic = 0xFFFFFFFF;
+    CHECK(image_select() == 0);
+}
+
+/* Feed `len` bytes of `img` in pieces of `step`, odd ones included. */
+static int write_in_steps(uint32_t len, uint32_t step)
+{
+    const uint8_t *p = (const uint8_t *) img;
+    int status = FWUPDATE_OK;
+
+    for (uint32_t i = 0; i < len && status == FWUPDATE_OK; i += step)
+        status = fwupdate_write(p + i, len - i < step ? len - i : step);
+    return status;
+}
+
+void test_fwupdate_image(void)
+{
+    uint32_t len = sizeof(img);
+
+    slots_erase();
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 41, BODY_WORDS);
+    qemu_running_slot = SLOT_A_BASE;
+
+    make_image(img, SLOT_B_BASE, 0, BODY_WORDS);
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    CHECK(write_in_steps(len, 77) == FWUPDATE_OK);
+
+    // the full chunks are in, the header is not: still the old image
+    CHECK(memcmp((void *) IMAGE_VECTORS(SLOT_B_BASE), img + IMAGE_HEADER_SIZE / 4,
+                 BODY_WORDS * 4 / FWUPDATE_CHUNK_SIZE * FWUPDATE_CHUNK_SIZE) == 0);
+    CHECK(slot_header(SLOT_B_BASE)->magic == 0xFFFFFFFF);
+    CHECK(image_select() == SLOT_A_BASE);
+
+    CHECK(fwupdate_finish() == FWUPDATE_OK);
+    CHECK(image_valid(SLOT_B_BASE));
+    CHECK(slot_header(SLOT_B_BASE)->seq == 42);
+    CHECK(image_select() == SLOT_B_BASE);
+
+    // back into A from B: the header a byte at a time, the rest in odd pieces
+    qemu_running_slot = SLOT_B_BASE;
+    make_image(img, SLOT_A_BASE, 0, BODY_WORDS);
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    CHECK(write_in_steps(IMAGE_HEADER_SIZE, 1) == FWUPDATE_OK);
+    CHECK(fwupdate_write(img + IMAGE_HEADER_SIZE / 4, len - IMAGE_HEADER_SIZE) == FWUPDATE_OK);
+    CHECK(fwupdate_finish() == FWUPDATE_OK);
+    CHECK(slot_header(SLOT_A_BASE)->seq == 43);
+    CHECK(image_select() == SLOT_A_BASE);
+
+    // a byte short, and a corrupted body: nothing is committed
+    qemu_running_slot = SLOT_A_BASE;
+    make_image(img, SLOT_B_BASE, 0, BODY_WORDS);
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    CHECK(write_in_steps(len - 1, 255) == FWUPDATE_OK);
+    CHECK(fwupdate_finish() == FWUPDATE_ERR_IMAGE);
+    CHECK(slot_header(SLOT_B_BASE)->magic == 0xFFFFFFFF);
+
+    img[IMAGE_HEADER_SIZE / 4 + 100] ^= 0x10;
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    CHECK(write_in_steps(len, 128) == FWUPDATE_OK);
+    CHECK(fwupdate_finish() == FWUPDATE_ERR_IMAGE);
+    CHECK(image_select() == SLOT_A_BASE);
+}
+
+void test_fwupdate_errors(void)
+{
+    slots_erase();
+    make_image((uint32_t *) SLOT_A_BASE, SLOT_A_BASE, 1, BODY_WORDS);
+
+    // not running from a slot
+    qemu_running_slot = 0;
+    CHECK(fwupdate_begin() == FWUPDATE_ERR_SLOT);
+    qemu_running_slot = SLOT_A_BASE;
+
+    // the slot is full before the image is
+    make_image(img, SLOT_B_BASE, 0, BODY_WORDS);
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    CHECK(fwupdate_write(img, sizeof(img)) == FWUPDATE_OK);
+    for (uint32_t n = sizeof(img); n + 256 <= SLOT_SIZE; n += 256)
+        CHECK(fwupdate_write(img + IMAGE_HEADER_SIZE / 4, 256) == FWUPDATE_OK);
+    CHECK(fwupdate_write(img + IMAGE_HEADER_SIZE / 4, 256) == FWUPDATE_ERR_SIZE);
+    CHECK(fwupdate_finish() == FWUPDATE_ERR_IMAGE);
+    CHECK(image_select() == SLOT_A_BASE);
+
+    // a program error: the queued chunk is dropped, neither call waits for it
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    CHECK(fwupdate_write(img, IMAGE_HEADER_SIZE + 300) == FWUPDATE_OK);
+    qemu_flash.SR = FLASH_SR_PGERR;
+    CHECK(fwupdate_write(img + IMAGE_HEADER_SIZE / 4 + 75, 600) == FWUPDATE_ERR_FLASH);
+    CHECK(fwupdate_finish() == FWUPDATE_ERR_FLASH);
+    CHECK(image_select() == SLOT_A_BASE);
+
+    // and one on the erase of the first page
+    CHECK(fwupdate_begin() == FWUPDATE_OK);
+    qemu_flash.SR = FLASH_SR_WRPRTERR;
+    CHECK(fwupdate_write(img, sizeof(img)) == FWUPDATE_ERR_FLASH);
+    CHECK(fwupdate_finish() == FWUPDATE_ERR_FLASH);
+    CHECK(image_select() == SLOT_A_BASE);
+}
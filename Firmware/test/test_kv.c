@@ -0,0 +1,132 @@
+/**
+ * @file   test_kv.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Checks of the key-value store, on the RAM-backed storage of
+ *         board_qemu.c.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "image.h"
+#include "kv.h"
+#include "harness.h"
+
+static void kv_idle(void)
+{
+    while (kv_poll() == KV_BUSY)
+        ;
+}
+
+static int kv_set_retry(uint16_t key, const void *data, uint16_t len)
+{
+    int status;
+
+    while ((status = kv_set(key, data, len)) == KV_BUSY)
+        kv_poll();
+    return status;
+}
+
+/**
+ * @brief Blank the storage and start over.
+ */
+static void kv_format(void)
+{
+    memset(qemu_storage, 0, STORAGE_SIZE);
+    kv_init();
+    kv_idle();
+}
+
+void test_kv_set_get(void)
+{
+    uint32_t a = 0x12345678, b = 0;
+    char s[16];
+
+    kv_format();
+    CHECK(kv_get(1, &b, sizeof(b)) == KV_NOT_FOUND);
+    CHECK(kv_set(1, &a, sizeof(a)) == KV_OK);
+    CHECK(kv_set(2, "hello", 6) == KV_OK);
+    CHECK(kv_get(1, &b, sizeof(b)) == sizeof(a) && b == a);
+    CHECK(kv_get(2, s, sizeof(s)) == 6 && !strcmp(s, "hello"));
+
+    a = 0xCAFEF00D;
+    CHECK(kv_set(1, &a, sizeof(a)) == KV_OK);
+    CHECK(kv_get(1, &b, sizeof(b)) == sizeof(a) && b == a);
+
+    CHECK(kv_delete(2) == KV_OK);
+    CHECK(kv_get(2, s, sizeof(s)) == KV_NOT_FOUND);
+    CHECK(kv_delete(2) == KV_NOT_FOUND);
+    CHECK(kv_set(KV_KEY_NONE, &a, sizeof(a)) == KV_INVALID);
+    CHECK(kv_set(3, &a, 0) == KV_INVALID);
+}
+
+/**
+ * @brief The index rebuilt at boot must give the same answers, and a
+ *        record whose commit never made it to flash must not count.
+ */
+void test_kv_reboot(void)
+{
+    static const char torn[] = "torn-torn-torn";
+    uint32_t v = 1, w = 0;
+
+    kv_format();
+    CHECK(kv_set(10, &v, sizeof(v)) == KV_OK);
+    CHECK(kv_set(11, "eleven", 7) == KV_OK);
+    CHECK(kv_delete(11) == KV_OK);
+    CHECK(kv_set(12, "old", 4) == KV_OK);
+    CHECK(kv_set(12, torn, sizeof(torn)) == KV_OK);
+
+    // power lost before the commit half-word of the newest record of 12
+    uint8_t *rec = NULL;
+    for (uint32_t i = 0; i + sizeof(torn) <= STORAGE_SIZE; i += 4)
+        if (!memcmp(&qemu_storage[i], torn, sizeof(torn)))
+            rec = &qemu_storage[i - sizeof(kv_record_t)];
+    CHECK(rec != NULL);
+    if (rec)
+        ((kv_record_t *) rec)->commit = 0xFFFF;
+
+    kv_init();
+    char s[16];
+    CHECK(kv_get(10, &w, sizeof(w)) == sizeof(v) && w == v);
+    CHECK(kv_get(11, s, sizeof(s)) == KV_NOT_FOUND);
+    CHECK(kv_get(12, s, sizeof(s)) == 4 && !strcmp(s, "old"));
+
+    // the log carries on behind the broken record
+    CHECK(kv_set(12, "new", 4) == KV_OK);
+    kv_init();
+    CHECK(kv_get(12, s, sizeof(s)) == 4 && !strcmp(s, "new"));
+}
+
+/**
+ * @brief Rewrite a calibration table many times over the storage size:
+ *        garbage collection has to keep up, other keys must survive and
+ *        the erases must spread over all pages.
+ */
+void test_kv_gc(void)
+{
+    uint8_t table[200], out[200];
+    uint32_t id = 0xA5A5A5A5, w = 0;
+    kv_stats_t stats;
+    int ok = 1;
+
+    kv_format();
+    CHECK(kv_set(1, &id, sizeof(id)) == KV_OK);
+    for (int n = 0; n < 400; ++n) {
+        memset(table, n, sizeof(table));
+        ok &= kv_set_retry(2, table, sizeof(table)) == KV_OK;
+    }
+    CHECK(ok);
+    kv_idle();
+
+    CHECK(kv_get(2, out, sizeof(out)) == sizeof(out) && !memcmp(out, table, sizeof(out)));
+    CHECK(kv_get(1, &w, sizeof(w)) == sizeof(w) && w == id);
+
+    kv_stats(&stats);
+    CHECK(stats.keys == 2);
+    CHECK(stats.free_pages >= KV_RESERVE_PAGES);
+    CHECK(stats.min_erases > 1 && stats.max_erases - stats.min_erases <= 1);
+
+    kv_init();
+    CHECK(kv_get(2, out, sizeof(out)) == sizeof(out) && !memcmp(out, table, sizeof(out)));
+    CHECK(kv_get(1, &w, sizeof(w)) == sizeof(w) && w == id);
+}
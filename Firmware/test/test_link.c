@@ -0,0 +1,255 @@
+/**
+ * @file   test_link.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  COBS, the reliable link between two ends in memory, with lost
+ *         and damaged frames, and telemetry packets.
+ */
+
+#include <string.h>
+#include "swtimer.h"
+#include "link.h"
+#include "tlm.h"
+#include "harness.h"
+
+typedef struct
+{
+    link_t   link;
+    uint8_t  out[2048];         /* written, not passed on yet */
+    uint32_t out_len;
+    uint32_t frames;            /* written */
+    uint32_t drop_at;           /* frame number to lose, 0: none */
+    uint32_t corrupt_at;        /* frame number to damage */
+    uint8_t  got[32];           /* first byte of each packet received */
+    uint32_t got_len;
+    uint8_t  last[LINK_MTU];
+    uint32_t last_len;
+} end_t;
+
+static end_t board, host;
+
+static void end_write(void *ctx, const uint8_t *buf, uint32_t len)
+{
+    end_t *e = ctx;
+
+    if (++e->frames == e->drop_at)
+        return;
+    if (e->out_len + len > sizeof(e->out))
+        return;
+    memcpy(e->out + e->out_len, buf, len);
+    if (e->frames == e->corrupt_at) {
+        uint8_t *c = &e->out[e->out_len + len / 2];
+        *c ^= (*c ^ 0x40) ? 0x40 : 0x20;
+    }
+    e->out_len += len;
+}
+
+static void end_recv(void *ctx, const uint8_t *data, uint32_t len)
+{
+    end_t *e = ctx;
+
+    if (e->got_len < sizeof(e->got))
+        e->got[e->got_len++] = len ? data[0] : 0;
+    memcpy(e->last, data, len);
+    e->last_len = len;
+}
+
+static void end_init(end_t *e)
+{
+    memset(e, 0, sizeof(*e));
+    link_init(&e->link, end_write, end_recv, e);
+}
+
+/* Pass the bytes on until both ends are quiet. */
+static void pump(void)
+{
+    static uint8_t buf[2048];
+
+    for (int i = 0; i < 32 && (board.out_len || host.out_len); ++i) {
+        end_t *from = board.out_len ? &board : &host;
+        end_t *to = from == &board ? &host : &board;
+        uint32_t n = from->out_len;
+
+        memcpy(buf, from->out, n);
+        from->out_len = 0;
+        link_input(&to->link, buf, n);
+    }
+}
+
+static void send_seq(uint8_t first, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; ++i) {
+        uint8_t p[4] = { (uint8_t) (first + i), 0, 0xFF, 0 };
+        CHECK(link_send(&board.link, p, sizeof(p)) == LINK_OK);
+    }
+}
+
+static int got_is(const end_t *e, const char *s)
+{
+    return e->got_len == strlen(s) && !memcmp(e->got, s, e->got_len);
+}
+
+void test_link_cobs(void)
+{
+    static const uint8_t plain[] = { 0x11, 0x22, 0x00, 0x33 };
+    static const uint8_t coded[] = { 0x03, 0x11, 0x22, 0x02, 0x33 };
+    uint8_t in[600], enc[610], dec[600];
+
+    CHECK(cobs_encode(plain, 4, enc) == 5 && !memcmp(enc, coded, 5));
+    CHECK(cobs_encode(plain, 0, enc) == 1 && enc[0] == 0x01);
+    CHECK(cobs_encode(plain + 2, 1, enc) == 2 && enc[0] == 1 && enc[1] == 1);
+
+    // a full block has no implied zero
+    memset(in, 0xA5, 254);
+    CHECK(cobs_encode(in, 254, enc) == 256 && enc[0] == 0xFF && enc[255] == 0x01);
+    CHECK(cobs_decode(enc, 256, dec, sizeof(dec)) == 254 && !memcmp(in, dec, 254));
+
+    for (uint32_t i = 0; i < sizeof(in); ++i)
+        in[i] = (i * 7) % 5 ? (uint8_t) (i * 31) : 0;
+    uint32_t n = cobs_encode(in, sizeof(in), enc);
+    CHECK(n <= sizeof(in) + sizeof(in) / 254 + 1 && !memchr(enc, 0, n));
+    CHECK(cobs_decode(enc, n, dec, sizeof(dec)) == (int32_t) sizeof(in));
+    CHECK(!memcmp(in, dec, sizeof(in)));
+
+    CHECK(cobs_decode(coded, 5, dec, 3) == -1);             // too long
+    CHECK(cobs_decode(coded, 4, dec, sizeof(dec)) == -1);   // cut short
+    static const uint8_t zero[] = { 0x03, 0x00, 0x11 };
+    CHECK(cobs_decode(zero, 3, dec, sizeof(dec)) == -1);
+}
+
+void test_link_in_order(void)
+{
+    swtimer_init();
+    end_init(&board);
+    end_init(&host);
+
+    send_seq('a', 5);
+    CHECK(link_in_flight(&board.link) == 5);
+    pump();
+    CHECK(got_is(&host, "abcde"));
+    CHECK(host.last_len == 4 && host.last[2] == 0xFF);
+    CHECK(link_in_flight(&board.link) == 0);
+    CHECK(board.link.stats.tx_frames == 5 && board.link.stats.tx_payload == 20);
+    CHECK(host.link.stats.rx_frames == 5 && board.link.stats.retransmits == 0);
+
+    // the window fills up without acknowledgements
+    send_seq('f', LINK_WINDOW);
+    CHECK(!link_ready(&board.link));
+    CHECK(link_send(&board.link, "x", 1) == LINK_AGAIN);
+    uint8_t big[LINK_MTU + 1] = { 0 };
+    CHECK(link_send(&board.link, big, sizeof(big)) == LINK_ERROR);
+    pump();
+    CHECK(link_ready(&board.link) && host.got_len == 5 + LINK_WINDOW);
+
+    // and the other way round
+    CHECK(link_send(&host.link, "z", 1) == LINK_OK);
+    pump();
+    CHECK(got_is(&board, "z") && link_in_flight(&host.link) == 0);
+}
+
+void test_link_loss(void)
+{
+    swtimer_init();
+    end_init(&board);
+    end_init(&host);
+
+    // the second frame is lost: 3 and 4 wait for it, only 2 is sent again
+    board.drop_at = 2;
+    send_seq('1', 4);
+    pump();
+    CHECK(got_is(&host, "1234"));
+    CHECK(host.link.stats.out_of_order == 2 && host.link.stats.naks_sent == 1);
+    CHECK(board.link.stats.retransmits == 1 && board.link.stats.naks_received == 1);
+    CHECK(link_in_flight(&board.link) == 0);
+
+    // a damaged frame is dropped, the timeout sends it again
+    board.corrupt_at = board.frames + 1;
+    send_seq('5', 1);
+    pump();
+    CHECK(host.link.stats.crc_errors == 1 && got_is(&host, "1234"));
+    link_poll(&board.link);
+    CHECK(board.link.stats.retransmits == 1);
+    for (uint32_t i = 0; i < SWTIMER_MS(LINK_RTO_MS); ++i)
+        swtimer_tick();
+    link_poll(&board.link);
+    pump();
+    CHECK(got_is(&host, "12345") && link_in_flight(&board.link) == 0);
+
+    // a lost ACK: the frame comes again and is not delivered twice
+    host.drop_at = host.frames + 1;
+    send_seq('6', 1);
+    pump();
+    CHECK(link_in_flight(&board.link) == 1);
+    for (uint32_t i = 0; i < SWTIMER_MS(LINK_RTO_MS); ++i)
+        swtimer_tick();
+    link_poll(&board.link);
+    pump();
+    CHECK(got_is(&host, "123456") && host.link.stats.duplicates == 1);
+    CHECK(link_in_flight(&board.link) == 0);
+
+    // garbage between frames costs only the frame it hits
+    static const uint8_t noise[] = { 0x05, 0x17, 0x00, 0xFF, 0x00 };
+    link_input(&host.link, noise, sizeof(noise));
+    send_seq('7', 1);
+    pump();
+    CHECK(got_is(&host, "1234567") && host.link.stats.framing_errors == 2);
+}
+
+typedef struct
+{
+    uint32_t tick;
+    int16_t  temp;
+    uint8_t  flags;
+    float    rpm;
+} status_t;
+
+static const tlm_field_t status_fields[] = {
+    TLM_FIELD(status_t, tick,  TLM_U32),
+    TLM_FIELD(status_t, temp,  TLM_I16),
+    TLM_FIELD(status_t, flags, TLM_U8),
+    TLM_FIELD(status_t, rpm,   TLM_F32),
+};
+static const tlm_record_t status_rec = TLM_RECORD(7, "status", status_fields);
+
+static uint32_t cmd_arg;
+
+static void cmd_set(const uint8_t *args, uint32_t len)
+{
+    cmd_arg = len ? args[0] : 0xFFFF;
+}
+
+void test_tlm(void)
+{
+    status_t s = { 0x04030201, -2, 0x5A, 1.0f };
+    uint8_t buf[64];
+
+    static const uint8_t record[] = {
+        TLM_RECORD_KIND, 7, 0x01, 0x02, 0x03, 0x04, 0xFE, 0xFF, 0x5A,
+        0x00, 0x00, 0x80, 0x3F,
+    };
+    CHECK(tlm_encode(&status_rec, &s, buf, sizeof(buf)) == sizeof(record));
+    CHECK(!memcmp(buf, record, sizeof(record)));
+    CHECK(tlm_encode(&status_rec, &s, buf, 8) == 0);
+
+    static const char schema[] = "\x02\x07status\0IhBf\0tick,temp,flags,rpm";
+    CHECK(tlm_describe(&status_rec, buf, sizeof(buf)) == sizeof(schema));
+    CHECK(!memcmp(buf, schema, sizeof(schema)));
+    CHECK(tlm_describe(&status_rec, buf, 20) == 0);
+
+    static const tlm_command_t cmds[] = { { 3, cmd_set } };
+    static const uint8_t set[] = { TLM_COMMAND_KIND, 3, 42 };
+    static const uint8_t unknown[] = { TLM_COMMAND_KIND, 4 };
+    CHECK(tlm_command(cmds, 1, set, sizeof(set)) == TLM_OK && cmd_arg == 42);
+    CHECK(tlm_command(cmds, 1, unknown, sizeof(unknown)) == TLM_ERROR);
+    CHECK(tlm_command(cmds, 1, record, sizeof(record)) == TLM_ERROR);
+
+    // through the link
+    swtimer_init();
+    end_init(&board);
+    end_init(&host);
+    CHECK(tlm_send_schema(&board.link, &status_rec) == LINK_OK);
+    CHECK(tlm_send(&board.link, &status_rec, &s) == LINK_OK);
+    pump();
+    CHECK(host.got_len == 2 && host.got[0] == TLM_SCHEMA_KIND);
+    CHECK(host.last_len == sizeof(record) && !memcmp(host.last, record, sizeof(record)));
+}
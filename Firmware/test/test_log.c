@@ -0,0 +1,79 @@
+/**
+ * @file   test_log.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Checks of the tokenized log ring, drained with log_read().
+ */
+
+#include "log.h"
+#include "harness.h"
+
+#define BUF_WORDS   (LOG_RING_WORDS + 8)
+
+static uint32_t buf[BUF_WORDS];
+
+void test_log_record(void)
+{
+    log_init();
+    LOG_INFO("boot");
+    LOG_WARN("adc %u mV, gain %d, %c, %x", 3300, -2, 'k', 0xBEEF);
+
+    uint32_t n = log_read(buf, BUF_WORDS);
+    CHECK(n == 2 + 6);
+
+    CHECK(buf[0] & LOG_HDR_VALID);
+    CHECK(LOG_HDR_NARGS(buf[0]) == 0);
+    CHECK(buf[2] & LOG_HDR_VALID);
+    CHECK(LOG_HDR_NARGS(buf[2]) == 4);
+    CHECK((buf[0] & LOG_ID_MASK) != (buf[2] & LOG_ID_MASK));
+    CHECK(buf[4] == 3300 && (int32_t) buf[5] == -2);
+    CHECK(buf[6] == 'k' && buf[7] == 0xBEEF);
+
+    // taken out, nothing left
+    CHECK(log_read(buf, BUF_WORDS) == 0);
+}
+
+void test_log_partial_read(void)
+{
+    log_init();
+    for (uint32_t i = 0; i < 3; ++i)
+        LOG_DEBUG("i %u", i);
+
+    // only whole records come out
+    CHECK(log_read(buf, 5) == 3);
+    CHECK(buf[2] == 0);
+    CHECK(log_read(buf, 6) == 6);
+    CHECK(buf[2] == 1 && buf[5] == 2);
+    CHECK(log_read(buf, BUF_WORDS) == 0);
+}
+
+void test_log_overflow(void)
+{
+    log_stats_t stats;
+    uint32_t records = LOG_RING_WORDS / 3;
+
+    log_init();
+    for (uint32_t i = 0; i < records + 10; ++i)
+        LOG_ERROR("e %u", i);
+
+    log_stats(&stats);
+    CHECK(stats.logged == records);
+    CHECK(stats.dropped == 10);
+
+    // the loss is reported first, then what fitted
+    uint32_t n = log_read(buf, BUF_WORDS);
+    CHECK(n == 3 + records * 3);
+    CHECK((buf[0] & LOG_ID_MASK) == LOG_ID_DROPPED);
+    CHECK(LOG_HDR_NARGS(buf[0]) == 1 && buf[2] == 10);
+    CHECK(buf[5] == 0 && buf[n - 1] == records - 1);
+
+    // room again, the ring wraps
+    for (uint32_t i = 0; i < records; ++i)
+        LOG_ERROR("e %u", i);
+    n = log_read(buf, BUF_WORDS);
+    CHECK(n == records * 3);
+    CHECK(buf[2] == 0 && buf[n - 1] == records - 1);
+
+    log_stats(&stats);
+    CHECK(stats.dropped == 10);
+}
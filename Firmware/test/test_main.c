@@ -0,0 +1,156 @@
+/**
+ * @file   test_main.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Entry point of the test image (make test).
+ */
+
+#include "semihost.h"
+#include "harness.h"
+
+// test_startup.c
+void test_startup_data(void);
+void test_startup_bss(void);
+void test_startup_vtor(void);
+void test_startup_lz4(void);
+void bench_startup_nop(void);
+
+// test_string.c
+void test_string_memcpy(void);
+void test_string_memset(void);
+void test_string_memmove(void);
+
+// test_dsp.c
+void test_dsp_fir_impulse(void);
+void test_dsp_biquad_dc_gain(void);
+void test_dsp_fft_tone(void);
+void test_dsp_rms(void);
+
+// test_kv.c
+void test_kv_set_get(void);
+void test_kv_reboot(void);
+void test_kv_gc(void);
+
+// test_swtimer.c
+void test_swtimer_oneshot_periodic(void);
+void test_swtimer_levels(void);
+void test_swtimer_coalesce(void);
+
+// test_log.c
+void test_log_record(void);
+void test_log_partial_read(void);
+void test_log_overflow(void);
+
+// test_watchdog.c
+void test_wdg_reset_cause(void);
+void test_wdg_refresh(void);
+void test_wdg_stall(void);
+
+// test_ptp.c
+void test_ptp_clock(void);
+void test_ptp_slave_converges(void);
+void test_ptp_ignores_others(void);
+void test_ptp_log_interval(void);
+
+// test_net.c
+void test_net_arp(void);
+void test_net_icmp(void);
+void test_net_udp_rx(void);
+void test_net_udp_tx(void);
+void test_net_other_ethertypes(void);
+
+// test_prof.c
+void test_prof_timer(void);
+void test_prof_samples(void);
+
+// test_defer.c
+void test_defer_priority(void);
+void test_defer_coalesce(void);
+void test_defer_full(void);
+
+// test_link.c
+void test_link_cobs(void);
+void test_link_in_order(void);
+void test_link_loss(void);
+void test_tlm(void);
+
+// test_cpuacct.c
+void test_cpuacct_nesting(void);
+void test_cpuacct_idle(void);
+void test_cpuacct_misuse(void);
+
+// test_fwupdate.c
+void test_image_valid(void);
+void test_image_select(void);
+void test_fwupdate_image(void);
+void test_fwupdate_errors(void);
+
+// test_reg.cpp
+void test_reg_fields(void);
+void test_reg_gpio(void);
+void test_reg_located_once(void);
+
+static const test_case_t tests[] = {
+    TEST_CASE(test_startup_data),
+    TEST_CASE(test_startup_bss),
+    TEST_CASE(test_startup_vtor),
+    TEST_CASE(test_startup_lz4),
+    TEST_CASE(test_string_memcpy),
+    TEST_CASE(test_string_memset),
+    TEST_CASE(test_string_memmove),
+    TEST_CASE(test_dsp_fir_impulse),
+    TEST_CASE(test_dsp_biquad_dc_gain),
+    TEST_CASE(test_dsp_fft_tone),
+    TEST_CASE(test_dsp_rms),
+    TEST_CASE(test_kv_set_get),
+    TEST_CASE(test_kv_reboot),
+    TEST_CASE(test_kv_gc),
+    TEST_CASE(test_swtimer_oneshot_periodic),
+    TEST_CASE(test_swtimer_levels),
+    TEST_CASE(test_swtimer_coalesce),
+    TEST_CASE(test_log_record),
+    TEST_CASE(test_log_partial_read),
+    TEST_CASE(test_log_overflow),
+    TEST_CASE(test_wdg_reset_cause),
+    TEST_CASE(test_wdg_refresh),
+    TEST_CASE(test_wdg_stall),
+    TEST_CASE(test_ptp_clock),
+    TEST_CASE(test_ptp_slave_converges),
+    TEST_CASE(test_ptp_ignores_others),
+    TEST_CASE(test_ptp_log_interval),
+    TEST_CASE(test_net_arp),
+    TEST_CASE(test_net_icmp),
+    TEST_CASE(test_net_udp_rx),
+    TEST_CASE(test_net_udp_tx),
+    TEST_CASE(test_net_other_ethertypes),
+    TEST_CASE(test_prof_timer),
+    TEST_CASE(test_prof_samples),
+    TEST_CASE(test_defer_priority),
+    TEST_CASE(test_defer_coalesce),
+    TEST_CASE(test_defer_full),
+    TEST_CASE(test_link_cobs),
+    TEST_CASE(test_link_in_order),
+    TEST_CASE(test_link_loss),
+    TEST_CASE(test_tlm),
+    TEST_CASE(test_cpuacct_nesting),
+    TEST_CASE(test_cpuacct_idle),
+    TEST_CASE(test_cpuacct_misuse),
+    TEST_CASE(test_image_valid),
+    TEST_CASE(test_image_select),
+    TEST_CASE(test_fwupdate_image),
+    TEST_CASE(test_fwupdate_errors),
+    TEST_CASE(test_reg_fields),
+    TEST_CASE(test_reg_gpio),
+    TEST_CASE(test_reg_located_once),
+};
+
+int main(void)
+{
+    harness_init();
+
+    int failed = harness_run(tests, sizeof(tests) / sizeof(tests[0]));
+
+    bench_startup_nop();
+
+    semihost_exit(failed);
+}
@@ -0,0 +1,337 @@
+/**
+ * @file   test_net.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  UDP/IPv4 stack against a peer on the simulated wire: the test
+ *         plays the DMA on the descriptors and checks the frames sent.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "eth.h"
+#include "net.h"
+#include "swtimer.h"
+#include "harness.h"
+#include "eth_model.h"
+
+#define HOST_IP         NET_IP(192, 168, 1, 10)
+#define PEER_IP         NET_IP(192, 168, 1, 20)
+#define GATEWAY_IP      NET_IP(192, 168, 1, 1)
+
+#define CIC_FULL        (3UL << 22)         /* TDES0, checksum insertion */
+
+static const uint8_t host_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static const uint8_t peer_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x20 };
+static const uint8_t gateway_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x99 };
+
+static uint8_t frame[256];
+static uint8_t sent[256];
+static uint32_t sent_len, sent_des0;
+
+static const uint8_t *got_data;
+static uint32_t got_len, got_ip, got_calls;
+static uint16_t got_port;
+
+/* ---- DMA ---- */
+
+/* Receive `len` bytes of `frame` with RDES0 checksum bits `csum`. */
+static uint8_t *deliver(uint32_t len, uint32_t csum)
+{
+    uint8_t *buf = (uint8_t *) eth_model_rx(frame, len, csum)[2];
+
+    net_poll();
+    return buf;
+}
+
+static int transmit(void)
+{
+    volatile uint32_t *d = eth_model_tx(sent, sizeof(sent), &sent_len);
+
+    if (!d)
+        return 0;
+    sent_des0 = d[0];
+    return 1;
+}
+
+/* ---- peer ---- */
+
+static void arp_frame(uint16_t op, const uint8_t *mac, uint32_t ip, uint32_t target)
+{
+    memset(frame, 0, sizeof(frame));
+    memset(frame, 0xFF, 6);
+    memcpy(frame + 6, mac, 6);
+    put16(frame + 12, 0x0806);
+    uint8_t *a = frame + 14;
+    put16(a, 1);
+    put16(a + 2, 0x0800);
+    a[4] = 6;
+    a[5] = 4;
+    put16(a + 6, op);
+    memcpy(a + 8, mac, 6);
+    put32(a + 14, ip);
+    put32(a + 24, target);
+}
+
+/* IPv4 packet from the peer, returns the start of its payload. */
+static uint8_t *ip_frame(uint32_t proto, uint32_t dst, uint32_t payload)
+{
+    memset(frame, 0, sizeof(frame));
+    memcpy(frame, host_mac, 6);
+    memcpy(frame + 6, peer_mac, 6);
+    put16(frame + 12, 0x0800);
+    uint8_t *ip = frame + 14;
+    ip[0] = 0x45;
+    put16(ip + 2, 20 + payload);
+    ip[8] = 64;
+    ip[9] = proto;
+    put32(ip + 12, PEER_IP);
+    put32(ip + 16, dst);
+    return ip + 20;
+}
+
+static uint8_t *udp_frame(uint16_t port, uint32_t len)
+{
+    uint8_t *u = ip_frame(17, HOST_IP, 8 + len);
+
+    put16(u, 7777);
+    put16(u + 2, port);
+    put16(u + 4, 8 + len);
+    return u + 8;
+}
+
+static void on_datagram(udp_socket_t *s, const uint8_t *data, uint32_t len,
+                        uint32_t ip, uint16_t port)
+{
+    (void) s;
+    got_data = data;
+    got_len = len;
+    got_ip = ip;
+    got_port = port;
+    got_calls++;
+}
+
+static void net_setup(void)
+{
+    memset(&qemu_eth, 0, sizeof(qemu_eth));
+    CHECK(eth_init(host_mac, 72000000) == ETH_OK);
+    swtimer_init();
+    net_init(host_mac, HOST_IP, NET_IP(255, 255, 255, 0), GATEWAY_IP);
+    eth_model_reset();
+    got_calls = 0;
+}
+
+void test_net_arp(void)
+{
+    net_stats_t st;
+
+    net_setup();
+
+    // a request for us is answered
+    arp_frame(1, peer_mac, PEER_IP, HOST_IP);
+    deliver(60, 0);
+    CHECK(transmit());
+    CHECK(memcmp(sent, peer_mac, 6) == 0 && memcmp(sent + 6, host_mac, 6) == 0);
+    CHECK(get16(sent + 12) == 0x0806 && get16(sent + 14 + 6) == 2);
+    CHECK(memcmp(sent + 14 + 8, host_mac, 6) == 0 && get32(sent + 14 + 14) == HOST_IP);
+    CHECK(memcmp(sent + 14 + 18, peer_mac, 6) == 0 && get32(sent + 14 + 24) == PEER_IP);
+    // and the asker is now known
+    CHECK(net_resolve(PEER_IP));
+
+    // one for another host is not
+    arp_frame(1, gateway_mac, GATEWAY_IP, NET_IP(192, 168, 1, 11));
+    deliver(60, 0);
+    CHECK(!transmit());
+    CHECK(!net_resolve(NET_IP(192, 168, 1, 30)));
+
+    // an unknown address is asked for from net_poll(), and retried
+    net_poll();
+    CHECK(transmit());
+    CHECK(memcmp(sent, "\xFF\xFF\xFF\xFF\xFF\xFF", 6) == 0 && get16(sent + 14 + 6) == 1);
+    CHECK(get32(sent + 14 + 24) == NET_IP(192, 168, 1, 30));
+    net_poll();
+    CHECK(!transmit());
+    for (uint32_t i = 0; i < SWTIMER_MS(NET_ARP_RETRY_MS); ++i)
+        swtimer_tick();
+    net_poll();
+    CHECK(transmit());
+
+    net_stats(&st);
+    CHECK(st.arp_tx == 3 && st.drops == 0);
+}
+
+void test_net_icmp(void)
+{
+    net_stats_t st;
+
+    net_setup();
+
+    uint8_t *icmp = ip_frame(1, HOST_IP, 8 + 32);
+    icmp[0] = 8;
+    put16(icmp + 2, 0xBEEF);                // a checksum, to be cleared
+    put16(icmp + 4, 0x1234);
+    put16(icmp + 6, 1);
+    for (int i = 0; i < 32; ++i)
+        icmp[8 + i] = i;
+    deliver(14 + 20 + 40, 1 << 5);
+
+    CHECK(transmit());
+    CHECK(sent_len == 14 + 20 + 40);
+    CHECK((sent_des0 & CIC_FULL) == CIC_FULL);
+    CHECK(memcmp(sent, peer_mac, 6) == 0 && memcmp(sent + 6, host_mac, 6) == 0);
+    const uint8_t *ip = sent + 14;
+    CHECK(get32(ip + 12) == HOST_IP && get32(ip + 16) == PEER_IP);
+    CHECK(get16(ip + 10) == 0);
+    CHECK(ip[20] == 0 && get16(ip + 22) == 0);
+    CHECK(get16(ip + 24) == 0x1234 && get16(ip + 26) == 1);
+    CHECK(memcmp(ip + 28, icmp + 8, 32) == 0);
+
+    // the MAC found a bad checksum: no reply
+    deliver(14 + 20 + 40, (1 << 5) | (1 << 0));
+    CHECK(!transmit());
+
+    net_stats(&st);
+    CHECK(st.icmp_echo == 1 && st.csum_errors == 1);
+}
+
+void test_net_udp_rx(void)
+{
+    udp_socket_t s, t;
+    net_stats_t st;
+    uint8_t *buf;
+
+    net_setup();
+    CHECK(udp_bind(&s, 5000, on_datagram, 0) == NET_OK);
+    CHECK(udp_bind(&t, 5000, on_datagram, 0) == NET_ERROR);
+
+    uint8_t *p = udp_frame(5000, 5);
+    memcpy(p, "hello", 5);
+    buf = deliver(14 + 20 + 8 + 5, 1 << 5);
+
+    // the payload is handed over where the DMA put it
+    CHECK(got_calls == 1);
+    CHECK(got_data == buf + UDP_PAYLOAD_OFFSET);
+    CHECK(got_len == 5 && memcmp(got_data, "hello", 5) == 0);
+    CHECK(got_ip == PEER_IP && got_port == 7777);
+
+    // nobody on this port
+    udp_frame(5001, 4);
+    deliver(60, 0);
+    // a fragment
+    udp_frame(5000, 4);
+    put16(frame + 14 + 6, 0x2000);
+    deliver(60, 0);
+    // someone else's
+    udp_frame(5000, 4);
+    put32(frame + 14 + 16, PEER_IP);
+    deliver(60, 0);
+    // UDP length beyond the IP packet
+    udp_frame(5000, 4);
+    put16(frame + 14 + 20 + 4, 40);
+    deliver(60, 0);
+    CHECK(got_calls == 1);
+
+    udp_unbind(&s);
+    udp_frame(5000, 4);
+    deliver(60, 0);
+    CHECK(got_calls == 1);
+
+    net_stats(&st);
+    CHECK(st.rx == 6 && st.udp_rx == 1);
+    CHECK(st.no_port == 2 && st.drops == 3);
+}
+
+void test_net_udp_tx(void)
+{
+    udp_socket_t s, far;
+    net_stats_t st;
+
+    net_setup();
+    CHECK(udp_bind(&s, 5001, 0, 0) == NET_OK);
+    CHECK(udp_connect(&s, PEER_IP, 6000) == NET_OK);
+
+    // no MAC yet
+    uint8_t *p = udp_alloc();
+    CHECK(p != 0);
+    CHECK(udp_send(&s, 16) == NET_UNRESOLVED);
+    CHECK(!transmit());
+    CHECK(!net_resolve(PEER_IP));
+
+    // net_poll() asks, the peer answers
+    net_poll();
+    CHECK(transmit());
+    CHECK(get16(sent + 14 + 6) == 1 && get32(sent + 14 + 24) == PEER_IP);
+    arp_frame(2, peer_mac, PEER_IP, HOST_IP);
+    memcpy(frame, host_mac, 6);
+    deliver(60, 0);
+
+    CHECK(net_resolve(PEER_IP));
+
+    p = udp_alloc();
+    CHECK(p != 0);
+    memset(p, 0xA5, UDP_MAX_PAYLOAD);
+    CHECK(udp_send(&s, UDP_MAX_PAYLOAD + 1) == NET_ERROR);
+    CHECK(udp_send(&s, UDP_MAX_PAYLOAD) == NET_OK);
+    CHECK(transmit());
+    CHECK(sent_len == UDP_PAYLOAD_OFFSET + UDP_MAX_PAYLOAD);
+    CHECK((sent_des0 & CIC_FULL) == CIC_FULL);
+    CHECK(memcmp(sent, peer_mac, 6) == 0 && memcmp(sent + 6, host_mac, 6) == 0);
+    CHECK(get16(sent + 12) == 0x0800);
+    const uint8_t *ip = sent + 14;
+    CHECK(ip[0] == 0x45 && get16(ip + 2) == ETH_MTU && ip[9] == 17);
+    CHECK(get16(ip + 6) == 0x4000 && get16(ip + 10) == 0);
+    CHECK(get32(ip + 12) == HOST_IP && get32(ip + 16) == PEER_IP);
+    CHECK(get16(ip + 20) == 5001 && get16(ip + 22) == 6000);
+    CHECK(get16(ip + 24) == 8 + UDP_MAX_PAYLOAD && get16(ip + 26) == 0);
+    CHECK(sent[UDP_PAYLOAD_OFFSET] == 0xA5);
+
+    // the ring fills up, the caller sees it before writing
+    for (int i = 0; i < ETH_TX_BUFS; ++i) {
+        CHECK(udp_alloc() != 0);
+        CHECK(udp_send(&s, 16) == NET_OK);
+    }
+    CHECK(udp_alloc() == 0);
+    CHECK(udp_send(&s, 16) == NET_AGAIN);
+    while (transmit())
+        ;
+    CHECK(udp_alloc() != 0);
+
+    // off the subnet through the gateway, broadcast without ARP
+    CHECK(udp_bind(&far, 5002, 0, 0) == NET_OK);
+    CHECK(udp_sendto(&far, NET_IP(10, 0, 0, 1), 53, 0) == NET_UNRESOLVED);
+    net_poll();
+    CHECK(transmit() && get32(sent + 14 + 24) == GATEWAY_IP);
+    CHECK(udp_sendto(&far, NET_BROADCAST, 53, 0) == NET_OK);
+    CHECK(transmit() && memcmp(sent, "\xFF\xFF\xFF\xFF\xFF\xFF", 6) == 0);
+
+    net_stats(&st);
+    CHECK(st.udp_tx == 6 && st.arp_tx == 2);
+}
+
+static int other_frames;
+
+static int count_other(const eth_frame_t *f)
+{
+    if (get16(f->data + 12) != 0x88F7)
+        return 0;
+    other_frames++;
+    return 1;
+}
+
+void test_net_other_ethertypes(void)
+{
+    net_stats_t st;
+
+    net_setup();
+    net_set_input(count_other);
+    other_frames = 0;
+
+    memset(frame, 0, sizeof(frame));
+    put16(frame + 12, 0x88F7);
+    deliver(60, 0);
+    put16(frame + 12, 0x86DD);
+    deliver(60, 0);
+
+    net_stats(&st);
+    CHECK(other_frames == 1);
+    CHECK(st.rx == 2 && st.drops == 1);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file   test_prof.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Profiler timer setup and sample recording, with the interrupt
+ *         played by calling the sampler on a made-up exception frame.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "prof.h"
+#include "harness.h"
+
+static uint32_t period(void)
+{
+    return (qemu_tim7.PSC + 1) * (qemu_tim7.ARR + 1);
+}
+
+void test_prof_timer(void)
+{
+    memset(&qemu_tim7, 0, sizeof(qemu_tim7));
+
+    CHECK(prof_start(72000000, 10000) == PROF_OK);
+    CHECK(qemu_tim7.PSC == 0 && qemu_tim7.ARR == 7199);
+    CHECK((qemu_tim7.DIER & 1) && (qemu_tim7.CR1 & 1));
+    CHECK(prof.rate_hz == 10000 && prof.magic == PROF_MAGIC);
+
+    // slow rates go through the prescaler
+    CHECK(prof_start(72000000, 100) == PROF_OK);
+    CHECK(qemu_tim7.PSC > 0 && qemu_tim7.ARR <= 0xFFFF);
+    CHECK(period() == 720000);
+    CHECK(prof_start(72000000, 1) == PROF_OK);
+    CHECK(period() == 72000000);
+
+    CHECK(prof_start(72000000, 0) == PROF_ERROR);
+    CHECK(prof_start(10000, 10000) == PROF_ERROR);
+
+    prof_stop();
+    CHECK(!(qemu_tim7.CR1 & 1) && qemu_tim7.DIER == 0);
+}
+
+void test_prof_samples(void)
+{
+    uint32_t frame[8] = { 0 };
+
+    memset(&qemu_tim7, 0, sizeof(qemu_tim7));
+    CHECK(prof_start(72000000, 10000) == PROF_OK);
+
+    for (uint32_t i = 0; i < PROF_SAMPLES + 3; ++i) {
+        frame[5] = 0x08000101 + 4 * i;      // lr
+        frame[6] = 0x08000200 + 2 * i;      // pc
+        qemu_tim7.SR = 1;
+        prof_sample(frame);
+        CHECK(qemu_tim7.SR == 0);
+    }
+
+    CHECK(prof.count == PROF_SAMPLES && prof.dropped == 3);
+    CHECK(prof.samples[0].pc == 0x08000200 && prof.samples[0].lr == 0x08000101);
+    CHECK(prof.samples[PROF_SAMPLES - 1].pc == 0x08000200 + 2 * (PROF_SAMPLES - 1));
+
+    prof_reset();
+    prof_sample(frame);
+    CHECK(prof.count == 1 && prof.dropped == 0);
+    prof_stop();
+}
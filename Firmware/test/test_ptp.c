@@ -0,0 +1,265 @@
+/**
+ * @file   test_ptp.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  PTP slave against a simulated master and a model of the MAC:
+ *         the test moves the system time in the register image at the
+ *         rate the addend sets, and plays the DMA on the descriptors.
+ */
+
+#include <string.h>
+#include "stm32f107xc.h"
+#include "eth.h"
+#include "ptp.h"
+#include "harness.h"
+#include "eth_model.h"
+
+#define HCLK_HZ         72000000
+#define NS_PER_SEC      1000000000LL
+#define PATH_DELAY      4700                /* ns, each way */
+#define OSC_ERROR       40e-6               /* slave HCLK fast by 40 ppm */
+
+// TDES0 time stamp bits
+#define TTSE            (1UL << 25)
+#define TTSS            (1UL << 17)
+
+static const uint8_t slave_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static const uint8_t master_port[10] = { 0x00, 0x11, 0x22, 0xFF, 0xFE, 0x33, 0x44, 0x55, 0x00, 0x01 };
+
+static int64_t true_ns;                     /* the master's time */
+static uint8_t frame[128];
+static uint8_t sent[128];
+static uint8_t sync_log_interval;           /* Sync logMessageInterval */
+
+/* ---- time stamp unit model ---- */
+
+static int64_t slave_now(void)
+{
+    return ptp_now();
+}
+
+static void slave_set(int64_t t)
+{
+    qemu_eth.PTPTSHR = t / NS_PER_SEC;
+    qemu_eth.PTPTSLR = ((uint64_t) (t % NS_PER_SEC) << 31) / NS_PER_SEC;
+}
+
+static void advance(int64_t ns)
+{
+    double rate = HCLK_HZ * (1 + OSC_ERROR) * qemu_eth.PTPTSAR / 4294967296.0 *
+                  qemu_eth.PTPSSIR / 2147483648.0;
+
+    slave_set(slave_now() + (int64_t) (ns * rate));
+    true_ns += ns;
+}
+
+/* ---- DMA, with the time stamp unit ---- */
+
+static void put_des_ts(volatile uint32_t *d, int64_t ts)
+{
+    d[2] = ((uint64_t) (ts % NS_PER_SEC) << 31) / NS_PER_SEC;
+    d[3] = ts / NS_PER_SEC;
+}
+
+static void deliver(uint32_t len)
+{
+    eth_frame_t f;
+
+    put_des_ts(eth_model_rx(frame, len, 0), slave_now());
+    CHECK(eth_rx(&f) == 1);
+    CHECK(ptp_input(&f) == 1);
+    eth_rx_release(&f);
+}
+
+static int transmit(void)
+{
+    uint32_t len;
+    volatile uint32_t *d = eth_model_tx(sent, sizeof(sent), &len);
+
+    if (!d)
+        return 0;
+    if (d[0] & TTSE) {
+        put_des_ts(d, slave_now());
+        d[0] |= TTSS;
+    }
+    return 1;
+}
+
+/* ---- master ---- */
+
+static void put_ts(uint8_t *p, int64_t t)
+{
+    uint32_t sec = t / NS_PER_SEC, ns = t % NS_PER_SEC;
+
+    memset(p, 0, 10);
+    put32(p + 2, sec);
+    put32(p + 6, ns);
+}
+
+static uint8_t *message(uint32_t type, uint32_t len, uint16_t seq)
+{
+    static const uint8_t dst[6] = { 0x01, 0x1B, 0x19, 0x00, 0x00, 0x00 };
+
+    memset(frame, 0, sizeof(frame));
+    memcpy(frame, dst, 6);
+    frame[6] = 0x02;
+    frame[12] = 0x88;
+    frame[13] = 0xF7;
+
+    uint8_t *m = frame + 14;
+    m[0] = type;
+    m[1] = 2;
+    m[3] = len;
+    memcpy(m + 20, master_port, 10);
+    put16(m + 30, seq);
+    return m;
+}
+
+/* One second of a two-step master: Sync, Follow_Up, then the Delay_Req. */
+static void master_second(uint16_t seq)
+{
+    int64_t t1 = true_ns;
+    uint8_t *m;
+
+    m = message(0x0, 44, seq);
+    m[6] = 0x02;                            // two-step
+    m[33] = sync_log_interval;
+    advance(PATH_DELAY);
+    deliver(14 + 44);
+
+    m = message(0x8, 44, seq);
+    put_ts(m + 34, t1);
+    advance(20000);
+    deliver(14 + 44);
+
+    ptp_poll();
+    advance(50000);
+    if (transmit()) {
+        CHECK(sent[12] == 0x88 && sent[13] == 0xF7 && (sent[14] & 0x0F) == 0x1);
+        advance(PATH_DELAY);
+        int64_t t4 = true_ns;
+
+        m = message(0x9, 54, get16(sent + 14 + 30));
+        put_ts(m + 34, t4);
+        memcpy(m + 44, sent + 14 + 20, 10);
+        advance(30000);
+        deliver(14 + 54);
+        ptp_poll();
+    }
+    advance(NS_PER_SEC - (true_ns % NS_PER_SEC));
+}
+
+static void ptp_setup(void)
+{
+    memset(&qemu_eth, 0, sizeof(qemu_eth));
+    CHECK(eth_init(slave_mac, HCLK_HZ) == ETH_OK);
+    ptp_init(slave_mac, HCLK_HZ);
+    eth_model_reset();
+}
+
+void test_ptp_clock(void)
+{
+    ptp_setup();
+    CHECK(qemu_eth.PTPTSCR & 1);
+    CHECK(qemu_eth.PTPSSIR > 0 && qemu_eth.PTPSSIR < 256);
+
+    uint32_t base = qemu_eth.PTPTSAR;
+    ptp_clock_adjfreq(1000);
+    CHECK(qemu_eth.PTPTSAR > base);
+    CHECK(qemu_eth.PTPTSAR - base == (uint32_t) ((uint64_t) base * 1000 / NS_PER_SEC));
+    ptp_clock_adjfreq(0);
+    CHECK(qemu_eth.PTPTSAR == base);
+
+    slave_set(5 * NS_PER_SEC + 250000000);
+    ptp_clock_step(-750000000);
+    int64_t t = ptp_now();
+    CHECK(t > 4 * NS_PER_SEC + 499999990 && t <= 4 * NS_PER_SEC + 500000000);
+    ptp_clock_step(1500000001);
+    t = ptp_now();
+    CHECK(t > 6 * NS_PER_SEC - 10 && t <= 6 * NS_PER_SEC + 1);
+}
+
+void test_ptp_slave_converges(void)
+{
+    ptp_status_t s;
+
+    ptp_setup();
+    true_ns = 1700000000LL * NS_PER_SEC + 123456789;
+    sync_log_interval = 0;
+
+    for (uint16_t seq = 0; seq < 40; ++seq)
+        master_second(seq);
+
+    ptp_status(&s);
+    CHECK(s.state == PTP_SLAVE);
+    CHECK(memcmp(s.master, master_port, 10) == 0);
+    CHECK(s.syncs == 40 && s.steps == 1);
+    CHECK(s.offset > -50 && s.offset < 50);
+    CHECK(s.delay > PATH_DELAY - 50 && s.delay < PATH_DELAY + 50);
+    // the correction cancels the oscillator error
+    CHECK(s.freq > -40000 - 200 && s.freq < -40000 + 200);
+
+    // and the clock agrees with the master
+    int64_t error = slave_now() - true_ns;
+    CHECK(error > -100 && error < 100);
+}
+
+void test_ptp_ignores_others(void)
+{
+    ptp_status_t s;
+    uint8_t *m;
+
+    ptp_setup();
+    true_ns = 1000LL * NS_PER_SEC;
+    master_second(1);
+
+    // a second master is not followed
+    m = message(0x0, 44, 7);
+    m[20] = 0x66;
+    deliver(14 + 44);
+    // nor is a PTPv1 message
+    m = message(0x0, 44, 8);
+    m[1] = 1;
+    deliver(14 + 44);
+
+    ptp_status(&s);
+    CHECK(s.syncs == 1);
+    CHECK(memcmp(s.master, master_port, 10) == 0);
+
+    // other EtherTypes are left to the caller
+    eth_frame_t f = { frame, 60, 0, { 0, 0 } };
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+    CHECK(ptp_input(&f) == 0);
+}
+
+void test_ptp_log_interval(void)
+{
+    static const uint8_t bad[2] = { 0x7F, 0x80 };
+    ptp_status_t ref[2], s;
+
+    // a run at the one-second interval
+    ptp_setup();
+    true_ns = 1700000000LL * NS_PER_SEC + 123456789;
+    sync_log_interval = 0;
+    for (uint16_t seq = 0; seq < 40; ++seq) {
+        master_second(seq);
+        if (seq % 20 == 19)
+            ptp_status(&ref[seq / 20]);
+    }
+
+    // the same run with values out of range both ways: ignored, the
+    // servo keeps the last good interval and follows the same course
+    ptp_setup();
+    true_ns = 1700000000LL * NS_PER_SEC + 123456789;
+    for (uint16_t seq = 0; seq < 40; ++seq) {
+        sync_log_interval = bad[seq / 20];
+        master_second(seq);
+        if (seq % 20 == 19) {
+            ptp_status(&s);
+            CHECK(s.state == PTP_SLAVE);
+            CHECK(s.offset == ref[seq / 20].offset && s.freq == ref[seq / 20].freq);
+        }
+    }
+    sync_log_interval = 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file   test_reg.cpp
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  C++ register layer and the gpio driver built on it: the stored
+ *         values, and every call locates its register once.
+ */
+
+#include <string.h>
+#include "stm32f107xc.hpp"
+
+extern "C" {
+#include "harness.h"
+#include "gpio.h"
+
+void test_reg_fields(void);
+void test_reg_gpio(void);
+void test_reg_located_once(void);
+}
+
+using namespace stm32;
+
+// what a field is at compile time
+static_assert(gpio::MODE<13>::mask == (3u << 20), "MODE13");
+static_assert(gpio::CNF<2>::mask == (3u << 10), "CNF2");
+static_assert(gpio::BR<13>::mask == (1u << 29), "BR13");
+static_assert(rcc::IOPCEN::mask == (1u << 4), "IOPCEN");
+static_assert(gpio::CNF<13>::is<gpio::AF_PUSH_PULL>().bits == (2u << 22), "CNF13 value");
+
+/* Counts how often the register is located. */
+struct counted
+{
+    static inline uint32_t word;
+    static inline uint32_t calls;
+
+    static volatile uint32_t *ptr()
+    {
+        ++calls;
+        return &word;
+    }
+};
+
+struct ctl;
+using EN    = reg::field<ctl, 0, 1>;
+using MODE  = reg::field<ctl, 4, 3>;
+using LEVEL = reg::field<ctl, 8, 8>;
+using BUSY  = reg::field<ctl, 31, 1, reg::access::ro>;
+using CTL   = reg::reg<counted, ctl>;
+
+void test_reg_fields(void)
+{
+    CHECK(MODE::val(9).bits == (1u << 4));      // cut to 3 bits
+    CHECK(LEVEL::is<0xA5>().bits == 0xA500);
+
+    counted::word = 0x80000000;
+    CHECK(CTL::get<BUSY>() == 1);
+    CHECK(CTL::get<LEVEL>(0x1234) == 0x12);
+
+    CTL::write(EN::set(), LEVEL::val(0x42));
+    CHECK(counted::word == 0x4201);
+    CTL::modify(MODE::is<5>());
+    CHECK(counted::word == 0x4251);
+    CTL::clear<EN, LEVEL>();
+    CHECK(counted::word == 0x0050);
+}
+
+void test_reg_gpio(void)
+{
+    memset(&qemu_rcc, 0, sizeof(qemu_rcc));
+    memset(qemu_gpio, 0, sizeof(GPIO_TypeDef) * 5);
+
+    // the driver from the reset state: PC13 push-pull 2 MHz, driven low
+    qemu_gpio[2].CRH = 0x44444444;
+    gpio_init();
+    CHECK(qemu_rcc.APB2ENR == (1u << 4));
+    CHECK(qemu_gpio[2].CRH == 0x44244444);
+    CHECK(qemu_gpio[2].BRR == (1u << 13));
+    gpio_off();
+    CHECK(qemu_gpio[2].BSRR == (1u << 13));
+
+    // replacing a configuration clears the old bits
+    qemu_gpio[0].CRL = 0x44444444;
+    gpio::PA::CRL::modify(gpio::MODE<2>::is<gpio::OUT_50MHZ>(),
+                          gpio::CNF<2>::is<gpio::AF_PUSH_PULL>());
+    CHECK(qemu_gpio[0].CRL == 0x44444B44);
+
+    gpio::PC::BSRR::write(gpio::BS<13>::set(), gpio::BR<14>::set());
+    CHECK(qemu_gpio[2].BSRR == ((1u << 13) | (1u << (14 + 16))));
+    gpio::PC::BRR::write(gpio::BRR<13>::set());
+    CHECK(qemu_gpio[2].BRR == (1u << 13));
+
+    qemu_gpio[3].IDR = 1u << 7;
+    CHECK(gpio::PD::IDR::get<gpio::IDR<7>>() == 1);
+    CHECK(gpio::PD::IDR::get<gpio::IDR<6>>() == 0);
+}
+
+/* Counts Location::ptr() calls, not the loads and stores through the
+ * pointer: how many of those a call makes is up to the compiler. */
+void test_reg_located_once(void)
+{
+    counted::calls = 0;
+    CTL::write(EN::set(), MODE::is<3>(), LEVEL::val(7));
+    CHECK(counted::calls == 1);
+
+    counted::calls = 0;
+    CTL::modify(EN::clear(), MODE::is<1>(), LEVEL::val(0xFF));
+    CHECK(counted::calls == 1);
+
+    counted::calls = 0;
+    uint32_t v = CTL::read();
+    CHECK(CTL::get<EN>(v) + CTL::get<MODE>(v) + CTL::get<LEVEL>(v) == 0x100);
+    CHECK(counted::calls == 1);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file   test_startup.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Checks of the reset path in startup_stm32f107xc.c.
+ */
+
+#include <string.h>
+#include "core_cm3.h"
+#include "harness.h"
+
+extern uint32_t _sdata;
+extern uint32_t _ebss;
+extern uint32_t startup_data_cycles;
+extern uint32_t startup_data_lz_bytes;
+extern void *const vector[];
+
+uint32_t lz4_decode(const uint8_t *src, uint8_t *dst, uint32_t size);
+
+static int init_var = 66;
+static int uninit_var;
+static int init0_var = 0;
+
+void test_startup_data(void)
+{
+    CHECK(init_var == 66);
+    init_var++;
+    CHECK(init_var == 67);
+}
+
+void test_startup_bss(void)
+{
+    CHECK(uninit_var == 0);
+    CHECK(init0_var == 0);
+}
+
+void test_startup_vtor(void)
+{
+    // the table the reset handler installed, not just any aligned value
+    CHECK(SCB_VTOR == (uint32_t) vector);
+    CHECK((SCB_VTOR & 0x7F) == 0);
+    CHECK((uint32_t) &_sdata < (uint32_t) &_ebss);
+}
+
+/* .data itself is checked by test_startup_data, unpacked with LZDATA=1. */
+void test_startup_lz4(void)
+{
+    // "abc", match 3 back for 9 (overlapping), last literals "xyzwv"
+    static const uint8_t overlap[] = {
+        0x35, 'a', 'b', 'c', 0x03, 0x00, 0x50, 'x', 'y', 'z', 'w', 'v',
+    };
+    // "z", match 1 back for 4 + 15 + 10, last literal "!"
+    static const uint8_t run[] = { 0x1F, 'z', 0x01, 0x00, 10, 0x10, '!' };
+    uint8_t out[32];
+
+    CHECK(lz4_decode(overlap, out, 17) == sizeof(overlap));
+    CHECK(memcmp(out, "abcabcabcabcxyzwv", 17) == 0);
+
+    memset(out, 0, sizeof(out));
+    CHECK(lz4_decode(run, out, 31) == sizeof(run));
+    CHECK(out[0] == 'z' && out[29] == 'z' && out[30] == '!' && out[31] == 0);
+
+    // stops at `size`, in a match or in literals
+    memset(out, 0, sizeof(out));
+    CHECK(lz4_decode(overlap, out, 10) == 6);
+    CHECK(memcmp(out, "abcabcabca", 10) == 0 && out[10] == 0);
+    memset(out, 0, sizeof(out));
+    CHECK(lz4_decode(overlap, out, 2) == 3);
+    CHECK(out[0] == 'a' && out[1] == 'b' && out[2] == 0);
+    CHECK(lz4_decode(run, out, 0) == 0);
+
+    harness_conf_u32("startup_data_cycles", startup_data_cycles);
+    harness_conf_u32("startup_data_lz_bytes", startup_data_lz_bytes);
+}
+
+void bench_startup_nop(void)
+{
+    uint32_t start = harness_cycles();
+    for (volatile int i = 0; i < 1000; ++i)
+        ;
+    harness_bench("empty_loop", 1000, harness_cycles() - start);
+}
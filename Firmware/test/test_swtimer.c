@@ -0,0 +1,120 @@
+/**
+ * @file   test_swtimer.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Checks of the timing-wheel software timers, ticked by hand.
+ */
+
+#include "swtimer.h"
+#include "harness.h"
+
+typedef struct
+{
+    swtimer_t timer;
+    uint32_t  due;
+    uint32_t  fired;
+    uint32_t  late;             /* fired on a tick other than `due` */
+    swtimer_t *victim;          /* stopped by the callback */
+} probe_t;
+
+static void probe_fn(void *arg)
+{
+    probe_t *p = arg;
+
+    if (swtimer_now() != p->due)
+        p->late++;
+    p->fired++;
+    p->due += p->timer.period;
+    if (p->victim)
+        swtimer_stop(p->victim);
+}
+
+static void probe_start(probe_t *p, uint32_t delay, uint32_t period, uint32_t slack)
+{
+    swtimer_setup(&p->timer, probe_fn, p);
+    p->due = swtimer_now() + delay;
+    p->fired = 0;
+    p->late = 0;
+    p->victim = 0;
+    swtimer_start(&p->timer, delay, period, slack);
+}
+
+static void run_ticks(uint32_t n)
+{
+    while (n--) {
+        swtimer_tick();
+        swtimer_poll();
+    }
+}
+
+void test_swtimer_oneshot_periodic(void)
+{
+    probe_t once, every5;
+
+    swtimer_init();
+    probe_start(&once, 10, 0, 0);
+    probe_start(&every5, 5, 5, 0);
+
+    run_ticks(50);
+    CHECK(once.fired == 1 && !once.late);
+    CHECK(!swtimer_running(&once.timer));
+    CHECK(every5.fired == 10 && !every5.late);
+
+    swtimer_stop(&every5.timer);
+    run_ticks(20);
+    CHECK(every5.fired == 10);
+}
+
+/**
+ * @brief Delays on both sides of every level boundary must fire on the
+ *        exact tick after cascading down the wheel.
+ */
+void test_swtimer_levels(void)
+{
+    static const uint32_t delays[] = {
+        1, 63, 64, 65, 127, 128, 4095, 4096, 4097, 70000, 262143, 262144, 300000,
+    };
+    probe_t probes[sizeof(delays) / sizeof(delays[0])];
+    int ok = 1;
+
+    swtimer_init();
+    run_ticks(37);                  // start off the slot grid
+    for (unsigned i = 0; i < sizeof(delays) / sizeof(delays[0]); ++i)
+        probe_start(&probes[i], delays[i], 0, 0);
+
+    run_ticks(300001);
+    for (unsigned i = 0; i < sizeof(delays) / sizeof(delays[0]); ++i)
+        ok &= probes[i].fired == 1 && !probes[i].late;
+    CHECK(ok);
+}
+
+/**
+ * @brief Timeouts with slack share wake-ups, a callback may stop a timer
+ *        that expires on the same tick.
+ */
+void test_swtimer_coalesce(void)
+{
+    probe_t probes[32];
+    swtimer_stats_t stats;
+    int ok = 1;
+
+    swtimer_init();
+    for (int i = 0; i < 32; ++i)
+        probe_start(&probes[i], 100 + i, 0, 31);
+    run_ticks(200);
+    swtimer_stats(&stats);
+    for (int i = 0; i < 32; ++i)
+        ok &= probes[i].fired == 1;
+    CHECK(ok);
+    CHECK(stats.expired == 32);
+    CHECK(stats.wakeups <= 2);
+
+    // same expiry tick, the first to run stops the other
+    swtimer_init();
+    probe_start(&probes[0], 10, 0, 0);
+    probe_start(&probes[1], 10, 0, 0);
+    probes[0].victim = &probes[1].timer;
+    probes[1].victim = &probes[0].timer;
+    run_ticks(20);
+    CHECK(probes[0].fired + probes[1].fired == 1);
+}
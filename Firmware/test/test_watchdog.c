@@ -0,0 +1,119 @@
+/**
+ * @file   test_watchdog.c
+ * @author cy023
+ * @date   2026.10.19
+ * @brief  Checks of the watchdog supervisor against the QEMU register
+ *         images, ticked by hand.
+ */
+
+#include "stm32f107xc.h"
+#include "swtimer.h"
+#include "watchdog.h"
+#include "harness.h"
+
+// RCC_CSR
+#define RCC_CSR_RMVF        (1UL << 24)
+#define RCC_CSR_PINRSTF     (1UL << 26)
+#define RCC_CSR_PORRSTF     (1UL << 27)
+#define RCC_CSR_WWDGRSTF    (1UL << 30)
+
+static void run_ticks(uint32_t n, int fast, int slow)
+{
+    while (n--) {
+        swtimer_tick();
+        if (fast != WDG_NONE)
+            wdg_checkin(fast);
+        if (slow != WDG_NONE && swtimer_now() % 40 == 0)
+            wdg_checkin(slow);
+    }
+}
+
+static int refreshed(void)
+{
+    int fed = qemu_iwdg.KR == 0xAAAA && qemu_wwdg.CR == 0xFF;
+
+    qemu_iwdg.KR = 0;
+    qemu_wwdg.CR = 0;
+    return fed;
+}
+
+void test_wdg_reset_cause(void)
+{
+    qemu_rcc.CSR = RCC_CSR_PORRSTF | RCC_CSR_PINRSTF;
+    wdg_init();
+    CHECK(wdg_last_reset()->cause == WDG_CAUSE_POWER);
+    CHECK(wdg_last_reset()->activity == WDG_NONE);
+    CHECK(qemu_rcc.CSR & RCC_CSR_RMVF);
+
+    qemu_rcc.CSR = RCC_CSR_PINRSTF;
+    wdg_init();
+    CHECK(wdg_last_reset()->cause == WDG_CAUSE_PIN);
+    CHECK(wdg_cause_name(WDG_CAUSE_PIN)[0] == 'p');
+}
+
+void test_wdg_refresh(void)
+{
+    qemu_rcc.CSR = RCC_CSR_PINRSTF;
+    wdg_init();
+    int fast = wdg_register(5);
+    int slow = wdg_register(50);
+    CHECK(fast != WDG_NONE && slow != WDG_NONE && fast != slow);
+
+    wdg_start(8000000, 1000);
+    CHECK(qemu_iwdg.RLR == 625 && qemu_iwdg.PR == 4);
+    CHECK((qemu_wwdg.CFR & 0x7F) == 0x7F);
+
+    for (int i = 0; i < 100; ++i) {
+        run_ticks(3, fast, slow);
+        CHECK(wdg_poll() == WDG_NONE);
+        CHECK(refreshed());
+    }
+
+    // a failed wdg_register() passed on, or a stray ID
+    wdg_checkin(WDG_NONE);
+    wdg_checkin(slow + 1);
+    wdg_checkin(WDG_MAX_ACTIVITIES);
+    run_ticks(3, fast, slow);
+    CHECK(wdg_poll() == WDG_NONE);
+}
+
+void test_wdg_stall(void)
+{
+    qemu_rcc.CSR = RCC_CSR_PINRSTF;
+    wdg_init();
+    int fast = wdg_register(5);
+    int slow = wdg_register(50);
+    wdg_start(8000000, 1000);
+
+    // the slow activity hangs, the fast one keeps going
+    run_ticks(45, fast, slow);
+    CHECK(wdg_poll() == WDG_NONE);
+    CHECK(refreshed());
+    run_ticks(60, fast, WDG_NONE);
+    CHECK(wdg_poll() == slow);
+    CHECK(!refreshed());
+
+    // not fed again, even if it recovers
+    run_ticks(10, fast, slow);
+    wdg_checkin(slow);
+    CHECK(wdg_poll() == slow);
+    CHECK(!refreshed());
+
+    // the early wake-up saves where the core was, then the reset
+    uint32_t frame[8] = { 0, 0, 0, 0, 0, 0x08001235, 0x08004568, 0x01000000 };
+    qemu_wwdg.SR = 1;
+    wdg_early_wakeup(frame);
+    CHECK(qemu_wwdg.SR == 0);
+
+    qemu_rcc.CSR = RCC_CSR_WWDGRSTF | RCC_CSR_PINRSTF;
+    wdg_init();
+    const wdg_report_t *r = wdg_last_reset();
+    CHECK(r->cause == WDG_CAUSE_WWDG);
+    CHECK(r->activity == slow && r->overdue > 0);
+    CHECK(r->pc == 0x08004568 && r->lr == 0x08001235);
+
+    // reported once
+    qemu_rcc.CSR = RCC_CSR_WWDGRSTF | RCC_CSR_PINRSTF;
+    wdg_init();
+    CHECK(wdg_last_reset()->activity == WDG_NONE);
+}
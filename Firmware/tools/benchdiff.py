@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+@file   benchdiff.py
+@author cy023
+@brief  Compare two 'make bench' logs and flag regressions.
+
+usage: benchdiff.py [--threshold PERCENT] base.log new.log
+
+Exits with status 1 when any benchmark got slower than the threshold.
+"""
+
+import argparse
+import sys
+
+
+def parse(path):
+    conf, bench = {}, {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 3 and fields[0] == "CONF":
+                conf[fields[1]] = fields[2]
+            elif len(fields) >= 4 and fields[0] == "BENCH":
+                iterations, cycles = int(fields[2]), int(fields[3])
+                bench[fields[1]] = cycles / iterations if iterations else 0.0
+    return conf, bench
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="regression threshold in percent (default 5)")
+    parser.add_argument("base")
+    parser.add_argument("new")
+    args = parser.parse_args()
+
+    base_conf, base = parse(args.base)
+    new_conf, new = parse(args.new)
+
+    for key in sorted(set(base_conf) | set(new_conf)):
+        old_value, new_value = base_conf.get(key, "-"), new_conf.get(key, "-")
+        mark = "" if old_value == new_value else "  (differs)"
+        print("# %-24s %-16s %-16s%s" % (key, old_value, new_value, mark))
+
+    print("%-32s %12s %12s %9s" % ("benchmark", "base", "new", "change"))
+    regressions = 0
+    for name in sorted(set(base) | set(new)):
+        if name not in base or name not in new:
+            print("%-32s %12s %12s" % (name, "%.1f" % base[name] if name in base else "-",
+                                       "%.1f" % new[name] if name in new else "-"))
+            continue
+        change = (new[name] - base[name]) * 100.0 / base[name] if base[name] else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        print("%-32s %12.1f %12.1f %+8.1f%%%s" % (name, base[name], new[name], change, mark))
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+@file   gen_dsp_tables.py
+@author cy023
+@brief  Generate the flash tables used by src/dsp.c.
+
+usage: gen_dsp_tables.py --fft-max-n N -o dsp_tables.c
+"""
+
+import argparse
+import math
+
+
+def q15(x):
+    return max(-32768, min(32767, int(round(x * 32768.0))))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--fft-max-n", type=int, default=256)
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    n = args.fft_max_n
+    m = n
+    while m > 1 and m % 4 == 0:
+        m //= 4
+    if n < 4 or m != 1:
+        parser.error("--fft-max-n must be a power of 4")
+
+    lines = []
+    for k in range(3 * n // 4):
+        angle = 2.0 * math.pi * k / n
+        lines.append("    %6d, %6d," % (q15(math.cos(angle)), q15(math.sin(angle))))
+
+    with open(args.output, "w") as f:
+        f.write("/* Generated by tools/gen_dsp_tables.py, do not edit. */\n\n")
+        f.write('#include "dsp.h"\n\n')
+        f.write("#if DSP_FFT_MAX_N != %d\n" % n)
+        f.write("#error \"DSP_FFT_MAX_N does not match the generated tables\"\n")
+        f.write("#endif\n\n")
+        f.write("const q15_t dsp_twiddle_q15[2 * DSP_FFT_MAX_N * 3 / 4] = {\n")
+        f.write("\n".join(lines))
+        f.write("\n};\n")
+
+
+if __name__ == "__main__":
+    main()
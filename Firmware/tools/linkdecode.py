@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+@file   linkdecode.py
+@author cy023
+@brief  Host end of the packet link of src/link.h and the telemetry
+        records of src/tlm.h.
+
+usage: linkdecode.py [--port DEV [--baud N]] [--time S] [--cmd ID[:HEX]] [capture]
+
+Reads a capture of the board's output, or talks to the board over a
+serial port and acknowledges its frames. Records are printed one per
+line once their schema has been seen, throughput goes to stderr at the
+end:
+
+    python3 tools/linkdecode.py --port /dev/ttyUSB0 --baud 921600 --time 10
+
+As a library:
+
+    link = Link(write=port.write)
+    tlm = Telemetry()
+    for packet in link.feed(port.read(4096)):
+        record = tlm.decode(packet)
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+DATA, ACK, NAK = 0, 1, 2
+HDR, CRC = 3, 4
+MTU = 128
+WINDOW = 8
+RTO = 0.1
+
+RECORD_KIND, SCHEMA_KIND, COMMAND_KIND = 1, 2, 3
+
+
+def _crc_table():
+    table = []
+    for i in range(256):
+        crc = i << 24
+        for _ in range(8):
+            crc = (crc << 1) ^ 0x04C11DB7 if crc & 0x80000000 else crc << 1
+        table.append(crc & 0xFFFFFFFF)
+    return table
+
+
+_CRC_TABLE = _crc_table()
+
+
+def crc32_stm32(data):
+    """The STM32 CRC unit over `data` zero-padded to 32-bit words."""
+    data = bytes(data) + b"\0" * (-len(data) % 4)
+    crc = 0xFFFFFFFF
+    for (word,) in struct.iter_unpack("<I", data):
+        crc ^= word
+        for _ in range(4):
+            crc = ((crc << 8) & 0xFFFFFFFF) ^ _CRC_TABLE[crc >> 24]
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray(b"\x01")
+    code_at = 0
+    for byte in data:
+        if byte:
+            out.append(byte)
+            out[code_at] += 1
+        if not byte or out[code_at] == 0xFF:
+            code_at = len(out)
+            out.append(1)
+    return bytes(out)
+
+
+def cobs_decode(data):
+    """Decoded bytes, or None if `data` is no valid encoding."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        block = data[i + 1:i + code]
+        if not code or len(block) != code - 1 or 0 in block:
+            return None
+        out += block
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Stats:
+    def __init__(self):
+        self.start = time.monotonic()
+        self.wire_rx = 0
+        self.wire_tx = 0
+        self.frames = 0
+        self.payload = 0
+        self.crc_errors = 0
+        self.framing_errors = 0
+        self.duplicates = 0
+        self.naks_sent = 0
+        self.retransmits = 0
+
+    def report(self, elapsed=None):
+        elapsed = elapsed or max(time.monotonic() - self.start, 1e-9)
+        lines = [
+            "frames      %u (%.1f/s)" % (self.frames, self.frames / elapsed),
+            "payload     %u bytes (%.0f B/s)" % (self.payload, self.payload / elapsed),
+            "wire        %u bytes in, %u out (%.0f B/s in)"
+            % (self.wire_rx, self.wire_tx, self.wire_rx / elapsed),
+            "efficiency  %.1f %% payload" % (100.0 * self.payload / max(self.wire_rx, 1)),
+            "errors      %u crc, %u framing, %u duplicates"
+            % (self.crc_errors, self.framing_errors, self.duplicates),
+            "recovery    %u NAKs sent, %u frames sent again" % (self.naks_sent, self.retransmits),
+        ]
+        return "\n".join(lines)
+
+
+class Link:
+    """One end of the link. feed() yields the payloads in order; ACKs,
+    NAKs and data frames go out through `write`, if given."""
+
+    def __init__(self, write=None, window=WINDOW):
+        self.write = write
+        self.window = window
+        self.raw = bytearray()
+        self.rx_next = 0
+        self.held = {}                          # seq: payload, ahead of a gap
+        self.nacked = set()
+        self.tx_seq = 0
+        self.tx_base = 0
+        self.unacked = {}                       # seq: [payload, sent at]
+        self.stats = Stats()
+
+    def _frame(self, ftype, seq, payload=b""):
+        body = bytes([ftype, seq & 0xFF, self.rx_next]) + payload
+        wire = cobs_encode(body + struct.pack("<I", crc32_stm32(body))) + b"\0"
+        self.stats.wire_tx += len(wire)
+        if self.write:
+            self.write(wire)
+
+    def send(self, payload):
+        """Queue one packet, False while the window is full."""
+        if len(payload) > MTU:
+            raise ValueError("payload over %u bytes" % MTU)
+        if len(self.unacked) >= self.window:
+            return False
+        seq = self.tx_seq
+        self.tx_seq = (seq + 1) & 0xFF
+        self.unacked[seq] = [bytes(payload), time.monotonic()]
+        self._frame(DATA, seq, payload)
+        return True
+
+    def command(self, ident, args=b""):
+        return self.send(bytes([COMMAND_KIND, ident]) + bytes(args))
+
+    def poll(self):
+        """Send again what has not been acknowledged in time."""
+        now = time.monotonic()
+        for seq, entry in self.unacked.items():
+            if now - entry[1] >= RTO:
+                entry[1] = now
+                self.stats.retransmits += 1
+                self._frame(DATA, seq, entry[0])
+
+    def _acked(self, ack):
+        if (ack - self.tx_base) & 0xFF <= len(self.unacked):
+            while self.tx_base != ack:
+                self.unacked.pop(self.tx_base, None)
+                self.tx_base = (self.tx_base + 1) & 0xFF
+
+    def _data(self, seq, payload):
+        ahead = (seq - self.rx_next) & 0xFF
+        if ahead >= self.window:
+            self.stats.duplicates += 1
+            self._frame(ACK, 0)
+            return
+        if ahead:
+            if seq in self.held:
+                self.stats.duplicates += 1
+                return
+            self.held[seq] = payload
+            s = self.rx_next
+            while s != seq:
+                if s not in self.held and s not in self.nacked:
+                    self.nacked.add(s)
+                    self.stats.naks_sent += 1
+                    self._frame(NAK, s)
+                s = (s + 1) & 0xFF
+            return
+        while payload is not None:
+            self.nacked.discard(self.rx_next)
+            self.rx_next = (self.rx_next + 1) & 0xFF
+            self.stats.frames += 1
+            self.stats.payload += len(payload)
+            yield payload
+            payload = self.held.pop(self.rx_next, None)
+        self._frame(ACK, 0)
+
+    def _decode(self, raw):
+        frame = cobs_decode(raw)
+        if frame is None or len(frame) < HDR + CRC:
+            self.stats.framing_errors += 1
+            return
+        body, (crc,) = frame[:-CRC], struct.unpack("<I", frame[-CRC:])
+        if crc32_stm32(body) != crc:
+            self.stats.crc_errors += 1
+            return
+        ftype, seq, ack = body[0], body[1], body[2]
+        self._acked(ack)
+        if ftype == DATA:
+            yield from self._data(seq, body[HDR:])
+        elif ftype == NAK and seq in self.unacked:
+            self.stats.retransmits += 1
+            self.unacked[seq][1] = time.monotonic()
+            self._frame(DATA, seq, self.unacked[seq][0])
+        elif ftype not in (ACK, NAK):
+            self.stats.framing_errors += 1
+
+    def feed(self, data):
+        """Yield the packets completed by `data`, in order."""
+        self.stats.wire_rx += len(data)
+        for byte in data:
+            if byte:
+                self.raw.append(byte)
+                continue
+            if self.raw:
+                yield from self._decode(bytes(self.raw))
+            self.raw.clear()
+
+
+class Telemetry:
+    """Records by schema, learnt from the schema packets."""
+
+    def __init__(self):
+        self.schemas = {}                       # id: (name, struct, fields)
+
+    def decode(self, packet):
+        """(name, {field: value}) for a record, None otherwise."""
+        if len(packet) < 2:
+            return None
+        kind, ident = packet[0], packet[1]
+        if kind == SCHEMA_KIND:
+            parts = packet[2:].split(b"\0")
+            if len(parts) >= 3:
+                name, codes, fields = (p.decode(errors="replace") for p in parts[:3])
+                self.schemas[ident] = (name, struct.Struct("<" + codes),
+                                       fields.split(",") if fields else [])
+            return None
+        if kind != RECORD_KIND or ident not in self.schemas:
+            return None
+        name, layout, fields = self.schemas[ident]
+        if len(packet) - 2 != layout.size:
+            return None
+        return name, dict(zip(fields, layout.unpack(packet[2:])))
+
+
+def open_port(path, baud):
+    import termios
+    import tty
+
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    speed = getattr(termios, "B%u" % baud)
+    attrs[4] = attrs[5] = speed
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 1                 # reads return after 100 ms
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def parse_command(text):
+    ident, _, args = text.partition(":")
+    return int(ident, 0), bytes.fromhex(args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", help="serial device, talk to the board")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--time", type=float, default=0, help="stop after S seconds")
+    parser.add_argument("--cmd", action="append", type=parse_command, default=[],
+                        help="command ID[:HEX ARGS] to send first, repeatable")
+    parser.add_argument("capture", nargs="?", help="recorded stream, default stdin")
+    args = parser.parse_args()
+
+    tlm = Telemetry()
+
+    def show(packets):
+        for packet in packets:
+            record = tlm.decode(packet)
+            if record:
+                name, values = record
+                print(name, " ".join("%s=%s" % kv for kv in values.items()), flush=True)
+
+    try:
+        if not args.port:
+            link = Link()
+            if args.capture:
+                with open(args.capture, "rb") as f:
+                    data = f.read()
+            else:
+                data = sys.stdin.buffer.read()
+            show(link.feed(data))
+        else:
+            fd = open_port(args.port, args.baud)
+            link = Link(write=lambda b: os.write(fd, b))
+            for ident, cmd_args in args.cmd:
+                link.command(ident, cmd_args)
+            end = time.monotonic() + args.time if args.time else None
+            while end is None or time.monotonic() < end:
+                show(link.feed(os.read(fd, 4096)))
+                link.poll()
+    except KeyboardInterrupt:
+        pass
+    except (OSError, ValueError) as err:
+        sys.exit("linkdecode: %s" % err)
+
+    print(link.stats.report(), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+@file   logdecode.py
+@author cy023
+@brief  Decode the tokenized log stream of src/log.h.
+
+usage: logdecode.py [--itm] [--clock HZ] firmware.elf [stream]
+
+The format strings come from the .log_fmt section of the ELF, the stream
+is the raw UART output or, with --itm, an SWO capture of ITM port 0.
+Without a stream file, stdin is read, e.g. from a serial port:
+
+    stty -F /dev/ttyUSB0 raw 115200
+    python3 tools/logdecode.py build/debug/m3bm.elf < /dev/ttyUSB0
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+HDR_VALID = 1 << 31
+ID_MASK = 0x00FFFFFF
+ID_DROPPED = ID_MASK
+MAX_ARGS = 4
+
+LEVELS = {"D": "DEBUG", "I": "INFO ", "W": "WARN ", "E": "ERROR"}
+
+SPEC = re.compile(r"%([-+ #0]*)(\d*|\*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+def elf_section(path, name):
+    """Contents of one section of a little-endian ELF32 file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("%s: not a little-endian ELF32 file" % path)
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def header(i):
+        return struct.unpack_from("<IIIIIIIIII", elf, shoff + i * shentsize)
+
+    strtab = header(shstrndx)
+    for i in range(shnum):
+        sh = header(i)
+        start = strtab[4] + sh[0]
+        if elf[start:elf.index(b"\0", start)].decode() == name:
+            return elf[sh[4]:sh[4] + sh[5]]
+    raise ValueError("%s: no %s section, is anything logged?" % (path, name))
+
+
+def load_formats(path):
+    """Map ID (offset in .log_fmt) to (level, location, format)."""
+    data = elf_section(path, ".log_fmt")
+    formats, offset = {}, 0
+    while offset < len(data):
+        end = data.index(b"\0", offset)
+        text = data[offset:end].decode(errors="replace")
+        if text.count("|") >= 2:
+            level, where, fmt = text.split("|", 2)
+            formats[offset] = (LEVELS.get(level, level), where, fmt)
+        offset = end + 1
+        # the next string may be aligned
+        while offset < len(data) and data[offset] == 0:
+            offset += 1
+    return formats
+
+
+def format_message(fmt, args):
+    """printf() on the host, every argument is a 32-bit word."""
+    args = list(args)
+
+    def convert(m):
+        flags, width, precision, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        if conv in "di":
+            value = value - (1 << 32) if value & (1 << 31) else value
+            conv = "d"
+        elif conv == "u":
+            conv = "d"
+        elif conv == "c":
+            value = chr(value & 0xFF)
+        elif conv in "sp":
+            return "0x%08x" % value
+        spec = "%" + flags + width + ("." + precision if precision else "") + conv
+        return spec % value
+
+    return SPEC.sub(convert, fmt)
+
+
+def itm_payload(data):
+    """Strip ITM framing, keep the software packets of stimulus port 0."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        header = data[i]
+        size = {1: 1, 2: 2, 3: 4}.get(header & 0x3, 0)
+        if size:
+            # source packet, software (bit 2 clear) or hardware (DWT)
+            if header & 0x4 == 0 and header >> 3 == 0:
+                out += data[i + 1:i + 1 + size]
+            i += 1 + size
+        elif header != 0x80 and header & 0x80 and (header & 0x0F == 0 or header & 0x0B == 0x08) \
+                or header in (0x94, 0xB4):
+            # timestamp or extension, continued while bit 7 is set
+            i += 1
+            while i < len(data) and data[i] & 0x80:
+                i += 1
+            i += 1
+        else:
+            i += 1                          # sync, overflow, short timestamp
+    return bytes(out)
+
+
+def decode(stream, formats, clock):
+    """Yield one line per record, resynchronising on garbage."""
+    words = [w for (w,) in struct.iter_unpack("<I", stream[:len(stream) // 4 * 4])]
+    i = 0
+    while i + 1 < len(words):
+        hdr = words[i]
+        nargs = (hdr >> 28) & 0x7
+        ident = hdr & ID_MASK
+        if not hdr & HDR_VALID or nargs > MAX_ARGS or (hdr >> 24) & 0xF \
+                or (ident not in formats and ident != ID_DROPPED):
+            i += 1
+            continue
+        if i + 2 + nargs > len(words):
+            break
+        stamp, args = words[i + 1], words[i + 2:i + 2 + nargs]
+        i += 2 + nargs
+
+        when = "%12.6f" % (stamp / clock) if clock else "%10u" % stamp
+        if ident == ID_DROPPED:
+            yield "%s DROP  %u messages lost" % (when, args[0] if args else 0)
+            continue
+        level, where, fmt = formats[ident]
+        yield "%s %s %s: %s" % (when, level, where, format_message(fmt, args))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--itm", action="store_true", help="stream is an SWO/ITM capture")
+    parser.add_argument("--clock", type=float, default=0,
+                        help="core clock in Hz, prints timestamps in seconds")
+    parser.add_argument("elf")
+    parser.add_argument("stream", nargs="?")
+    args = parser.parse_args()
+
+    try:
+        formats = load_formats(args.elf)
+        if args.stream:
+            with open(args.stream, "rb") as f:
+                stream = f.read()
+        else:
+            stream = sys.stdin.buffer.read()
+    except (OSError, ValueError) as err:
+        sys.exit("logdecode: %s" % err)
+
+    if args.itm:
+        stream = itm_payload(stream)
+    for line in decode(stream, formats, args.clock):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+@file   lzdata.py
+@author cy023
+@brief  Compress the .data load image of a firmware ELF (LZDATA=1).
+
+usage: lzdata.py plain.elf data_lz.c
+       lzdata.py --verify plain.elf final.elf
+
+The first form compresses .data of the first link into an LZ4 block and
+writes it as a C array in section .data_lz, for the second link, which
+puts it where the .data load image was. The array starts with the length
+of the block. Should the block not be smaller, the length is 0 and .data
+follows as it is. The second form checks that the second link changed
+nothing but that flash range, which now ends with .data_lz, and that it
+gives the original .data.
+"""
+
+import argparse
+import struct
+import sys
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 2
+
+MIN_MATCH = 4
+LAST_LITERALS = 5                           # LZ4 block format end rules
+MATCH_LIMIT = 12
+MAX_OFFSET = 0xFFFF
+
+
+def _string(elf, at):
+    return elf[at:elf.index(b"\0", at)].decode()
+
+
+def elf_read(path):
+    """Sections of a little-endian ELF32 file, name: (type, flags,
+    address, size, contents), and its symbols, name: value."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("%s: not a little-endian ELF32 file" % path)
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+    headers = [struct.unpack_from("<IIIIIII", elf, shoff + i * shentsize)
+               for i in range(shnum)]
+
+    sections = {}
+    symbols = {}
+    for name, stype, flags, addr, offset, size, link in headers:
+        name = _string(elf, headers[shstrndx][4] + name)
+        contents = b"" if stype == SHT_NOBITS else elf[offset:offset + size]
+        sections[name] = (stype, flags, addr, size, contents)
+        if stype == SHT_SYMTAB:
+            strtab = headers[link][4]
+            for at in range(offset, offset + size, 16):
+                sym_name, value = struct.unpack_from("<II", elf, at)
+                if sym_name:
+                    symbols[_string(elf, strtab + sym_name)] = value
+    return sections, symbols
+
+
+def _length(out, n):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def _sequence(out, literals, offset=0, match=0):
+    lit = len(literals)
+    token = min(lit, 15) << 4
+    if match:
+        token |= min(match - MIN_MATCH, 15)
+    out.append(token)
+    if lit >= 15:
+        _length(out, lit - 15)
+    out += literals
+    if match:
+        out += struct.pack("<H", offset)
+        if match - MIN_MATCH >= 15:
+            _length(out, match - MIN_MATCH - 15)
+
+
+def lz4_compress(data):
+    """One LZ4 block, greedy matching on a hash of 4 bytes."""
+    out = bytearray()
+    if not data:
+        return bytes(out)
+
+    table = {}
+    anchor = i = 0
+    while i + MATCH_LIMIT <= len(data):
+        key = data[i:i + MIN_MATCH]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > MAX_OFFSET:
+            i += 1
+            continue
+
+        longest = len(data) - LAST_LITERALS - i
+        n = MIN_MATCH
+        while n < longest and data[cand + n] == data[i + n]:
+            n += 1
+        _sequence(out, data[anchor:i], i - cand, n)
+        for j in range(i + 1, min(i + n, len(data) - MIN_MATCH)):
+            table[data[j:j + MIN_MATCH]] = j
+        i += n
+        anchor = i
+    _sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def lz4_decompress(block):
+    out = bytearray()
+    i = 0
+    while i < len(block):
+        token = block[i]
+        i += 1
+        n = token >> 4
+        if n == 15:
+            while True:
+                n += block[i]
+                i += 1
+                if block[i - 1] != 255:
+                    break
+        out += block[i:i + n]
+        i += n
+        if i >= len(block):
+            break
+        offset, = struct.unpack_from("<H", block, i)
+        i += 2
+        n = (token & 15) + MIN_MATCH
+        if n == 19:
+            while True:
+                n += block[i]
+                i += 1
+                if block[i - 1] != 255:
+                    break
+        for _ in range(n):
+            out.append(out[-offset])
+    return bytes(out)
+
+
+def load_image(data):
+    """What goes where the .data load image was: the length and the LZ4
+    block, or 0 and .data itself when the block is not smaller."""
+    block = lz4_compress(data)
+    if len(block) < len(data):
+        return struct.pack("<I", len(block)) + block
+    return struct.pack("<I", 0) + data
+
+
+def unpack(image, size):
+    packed, = struct.unpack_from("<I", image)
+    if packed:
+        return lz4_decompress(image[4:4 + packed])
+    return image[4:4 + size]
+
+
+def pack(plain, output):
+    sections, _ = elf_read(plain)
+    if ".data" not in sections:
+        raise ValueError("%s: no .data section" % plain)
+    data = sections[".data"][4]
+    image = load_image(data)
+    packed, = struct.unpack_from("<I", image)
+    if unpack(image, len(data)) != data:
+        raise ValueError("LZ4 round trip failed")
+
+    lines = [
+        "/* Generated by tools/lzdata.py from %s, do not edit. */" % plain,
+        "",
+        "#include <stdint.h>",
+        "",
+        "/* .data: %u bytes, load image: %u bytes%s */"
+        % (len(data), len(image), ", LZ4" if packed else ""),
+        "const uint8_t data_lz[%u] __attribute__((section(\".data_lz\"), used, aligned(4))) = {"
+        % len(image),
+    ]
+    for at in range(0, len(image), 12):
+        lines.append("    " + " ".join("0x%02X," % b for b in image[at:at + 12]))
+    lines.append("};")
+    with open(output, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+    saved = len(data) - len(image)
+    print("lzdata: .data %u bytes -> %u bytes (%.0f %%), %d bytes of flash saved"
+          % (len(data), len(image), 100.0 * len(image) / max(len(data), 1), saved))
+
+
+def verify(plain, final):
+    (a, a_syms), (b, b_syms) = elf_read(plain), elf_read(final)
+    errors = []
+
+    # everything the code can refer to stays where it was
+    for name, (stype, flags, addr, size, contents) in a.items():
+        if not flags & SHF_ALLOC or name == ".data":
+            continue
+        if name not in b:
+            errors.append("%s is missing" % name)
+        elif b[name][2:] != (addr, size, contents):
+            errors.append("%s differs" % name)
+    for name in ("_sdata", "_edata", "_la_data"):
+        if a_syms.get(name) != b_syms.get(name):
+            errors.append("%s moved" % name)
+    if a[".data"][2:4] != b[".data"][2:4]:
+        errors.append(".data moved")
+    if not a_syms.get("_lzdata") or not b_syms.get("_lzdata"):
+        errors.append("_lzdata is not defined, the reset handler would copy .data_lz")
+
+    data = a[".data"][4]
+    if ".data_lz" not in b:
+        errors.append(".data_lz is missing")
+    else:
+        image = b[".data_lz"][4]
+        if b[".data"][0] != SHT_NOBITS:
+            errors.append(".data is still loaded from flash")
+        if b[".data_lz"][2] != a_syms.get("_la_data"):
+            errors.append(".data_lz is not at _la_data")
+        if len(image) < 4 or unpack(image, len(data))[:len(data)] != data:
+            errors.append(".data_lz does not unpack to .data")
+
+    if errors:
+        raise ValueError("%s: %s" % (final, ", ".join(errors)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--verify", action="store_true",
+                        help="check the second link against the first")
+    parser.add_argument("plain", help="ELF of the first link")
+    parser.add_argument("output", help="C file to write, or with --verify the final ELF")
+    args = parser.parse_args()
+
+    try:
+        if args.verify:
+            verify(args.plain, args.output)
+        else:
+            pack(args.plain, args.output)
+    except (OSError, ValueError) as err:
+        sys.exit("lzdata: %s" % err)
+
+
+if __name__ == "__main__":
+    main()
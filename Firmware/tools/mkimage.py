@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""
+@file   mkimage.py
+@author cy023
+@brief  Prepend the A/B image header (src/image.h) to a slot binary.
+
+usage: mkimage.py [--seq N] in.bin out.img
+
+The CRC is the one of the STM32 CRC unit (crc32_hw()): CRC-32 polynomial,
+initial value 0xFFFFFFFF, MSB first over 32-bit little-endian words, no
+final XOR.
+"""
+
+import argparse
+import struct
+import sys
+
+IMAGE_HEADER_SIZE = 0x200
+IMAGE_MAGIC = 0x4D42334D
+SLOT_SIZE = 112 * 1024
+
+
+def crc32_stm32(data):
+    crc = 0xFFFFFFFF
+    for (word,) in struct.iter_unpack("<I", data):
+        crc ^= word
+        for _ in range(32):
+            crc = ((crc << 1) ^ 0x04C11DB7 if crc & 0x80000000 else crc << 1) & 0xFFFFFFFF
+    return crc
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--seq", type=int, default=1, help="sequence number, higher is newer")
+    parser.add_argument("input")
+    parser.add_argument("output")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        body = f.read()
+    body += b"\xff" * (-len(body) % 4)
+    if len(body) > SLOT_SIZE - IMAGE_HEADER_SIZE:
+        sys.exit("mkimage: %s is %d bytes, the slot holds %d"
+                 % (args.input, len(body), SLOT_SIZE - IMAGE_HEADER_SIZE))
+
+    hdr = struct.pack("<7I", IMAGE_MAGIC, args.seq & 0xFFFFFFFF, len(body),
+                      crc32_stm32(body), 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF)
+    hdr += struct.pack("<I", crc32_stm32(hdr))
+    hdr += b"\xff" * (IMAGE_HEADER_SIZE - len(hdr))
+
+    with open(args.output, "wb") as f:
+        f.write(hdr + body)
+
+
+if __name__ == "__main__":
+    main()
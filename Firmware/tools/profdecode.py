@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""
+@file   profdecode.py
+@author cy023
+@brief  Flat profile and collapsed stacks from the samples of src/prof.h.
+
+usage: profdecode.py [--collapsed] [--top N] symbols prof.bin
+
+`symbols` is the .sym file the Makefile writes next to the ELF (nm -n)
+or the .elf itself. prof.bin is the `prof` buffer, dumped from gdb:
+
+    (gdb) dump binary value prof.bin prof
+
+--collapsed prints one "caller;function count" line per stack for
+flamegraph.pl. A sample holds only the PC and LR, so the stacks are at
+most two deep: the LR names the caller while the sampled function has
+not called anything yet, otherwise it points back into the function
+itself and the stack is the function alone.
+"""
+
+import argparse
+import bisect
+import struct
+import sys
+
+PROF_MAGIC = 0x464F5250
+HEADER = struct.Struct("<IIII")
+SAMPLE = struct.Struct("<II")
+STT_FUNC = 2
+SHT_SYMTAB = 2
+
+
+def elf_functions(path):
+    """(start, size, name) of the functions in a little-endian ELF32 file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        raise ValueError("%s: not a little-endian ELF32 file" % path)
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+
+    def header(i):
+        return struct.unpack_from("<IIIIIIIIII", elf, shoff + i * shentsize)
+
+    funcs = []
+    for i in range(shnum):
+        sh = header(i)
+        if sh[1] != SHT_SYMTAB:
+            continue
+        strtab = header(sh[6])
+        for off in range(sh[4], sh[4] + sh[5], 16):
+            name, value, size, info = struct.unpack_from("<IIIB", elf, off)
+            if info & 0xF != STT_FUNC:
+                continue
+            start = strtab[4] + name
+            funcs.append((value & ~1, size, elf[start:elf.index(b"\0", start)].decode()))
+    return funcs
+
+
+def sym_functions(path):
+    """(start, size, name) from `nm -n` output, each function up to the
+    next symbol at a higher address."""
+    syms = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split(None, 2)
+            if len(fields) == 3:
+                syms.append((int(fields[0], 16) & ~1, fields[1] in "tTwW", fields[2].strip()))
+    syms.sort(key=lambda s: s[0])
+    starts = sorted({s[0] for s in syms})
+    funcs = []
+    for start, is_text, name in syms:
+        if is_text:
+            i = bisect.bisect_right(starts, start)
+            end = starts[i] if i < len(starts) else start
+            funcs.append((start, end - start, name))
+    return funcs
+
+
+class Symbols:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            is_elf = f.read(4) == b"\x7fELF"
+        funcs = elf_functions(path) if is_elf else sym_functions(path)
+        # aliases share an address, keep the name listed first
+        first = {}
+        for f in funcs:
+            first.setdefault(f[0], f)
+        funcs = sorted(first.values())
+        self.starts = [f[0] for f in funcs]
+        self.funcs = funcs
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.starts, addr) - 1
+        if i >= 0:
+            start, size, name = self.funcs[i]
+            if addr < start + size:
+                return name
+        return "[0x%08x]" % addr
+
+
+def load_samples(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise ValueError("%s: too short" % path)
+    magic, rate, count, dropped = HEADER.unpack_from(data)
+    if magic != PROF_MAGIC:
+        raise ValueError("%s: not a prof buffer (magic 0x%08x)" % (path, magic))
+    count = min(count, (len(data) - HEADER.size) // SAMPLE.size)
+    samples = [SAMPLE.unpack_from(data, HEADER.size + i * SAMPLE.size) for i in range(count)]
+    return rate, dropped, samples
+
+
+def stack(symbols, pc, lr):
+    func = symbols.lookup(pc & ~1)
+    if lr >= 0xFFFFFFE0:
+        # EXC_RETURN: a handler that has not called anything
+        return ("[exception]", func)
+    # the return address is just past the call
+    caller = symbols.lookup((lr & ~1) - 2)
+    return (func,) if caller == func else (caller, func)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[3])
+    ap.add_argument("--collapsed", action="store_true", help="collapsed stacks for flamegraph.pl")
+    ap.add_argument("--top", type=int, default=30, help="rows of the flat profile (default 30)")
+    ap.add_argument("symbols", help=".sym or .elf of the profiled image")
+    ap.add_argument("samples", help="dump of the prof buffer")
+    args = ap.parse_args()
+
+    try:
+        symbols = Symbols(args.symbols)
+        rate, dropped, samples = load_samples(args.samples)
+    except (OSError, ValueError) as e:
+        sys.exit("profdecode.py: %s" % e)
+
+    if args.collapsed:
+        stacks = {}
+        for pc, lr in samples:
+            key = ";".join(stack(symbols, pc, lr))
+            stacks[key] = stacks.get(key, 0) + 1
+        for key in sorted(stacks):
+            print("%s %d" % (key, stacks[key]))
+        return
+
+    total = len(samples)
+    print("%d samples at %d Hz (%.1f ms), %d dropped" %
+          (total, rate, total * 1000.0 / rate if rate else 0, dropped))
+    if not total:
+        return
+
+    flat = {}
+    for pc, _ in samples:
+        name = symbols.lookup(pc & ~1)
+        flat[name] = flat.get(name, 0) + 1
+
+    print()
+    print("%8s %7s %7s  %s" % ("samples", "%", "cum %", "function"))
+    cum = 0
+    for name, n in sorted(flat.items(), key=lambda kv: (-kv[1], kv[0]))[:args.top]:
+        cum += n
+        print("%8d %7.2f %7.2f  %s" % (n, 100.0 * n / total, 100.0 * cum / total, name))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+@file   sizediff.py
+@author cy023
+@brief  Per-section / per-symbol size difference between two ELF files.
+
+usage: sizediff.py [--nm NM] [--all] base.elf new.elf
+
+Only sections that take flash or RAM are compared, not debug information.
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+
+SHF_ALLOC = 2
+
+
+def sections(elf):
+    """Name: size of the allocated sections of a little-endian ELF32 file."""
+    with open(elf, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise OSError("%s: not a little-endian ELF32 file" % elf)
+
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+    headers = [struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+               for i in range(shnum)]
+    names = headers[shstrndx][4]
+
+    result = {}
+    for name, _, flags, _, _, size in headers:
+        if flags & SHF_ALLOC:
+            start = names + name
+            result[data[start:data.index(b"\0", start)].decode()] = size
+    return result
+
+
+def symbols(nm, elf):
+    out = subprocess.check_output([nm, "-S", "-C", "--size-sort", elf], text=True)
+    result = {}
+    for line in out.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) != 4:
+            continue
+        size, kind, name = int(fields[1], 16), fields[2], fields[3]
+        key = "%s %s" % (kind.upper(), name)
+        result[key] = result.get(key, 0) + size
+    return result
+
+
+def report(title, base, new, show_all):
+    rows = []
+    for key in sorted(set(base) | set(new)):
+        old_size, new_size = base.get(key, 0), new.get(key, 0)
+        if old_size != new_size or show_all:
+            rows.append((new_size - old_size, key, old_size, new_size))
+    rows.sort(key=lambda r: (-abs(r[0]), r[1]))
+
+    print(title)
+    print("%-48s %10s %10s %+10s" % ("name", "base", "new", "delta"))
+    for delta, key, old_size, new_size in rows:
+        print("%-48s %10d %10d %+10d" % (key, old_size, new_size, delta))
+    total = sum(new.values()) - sum(base.values())
+    print("%-48s %10d %10d %+10d" % ("total", sum(base.values()), sum(new.values()), total))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    parser.add_argument("--all", action="store_true", help="list unchanged entries too")
+    parser.add_argument("base")
+    parser.add_argument("new")
+    args = parser.parse_args()
+
+    try:
+        report("sections", sections(args.base), sections(args.new), args.all)
+        report("symbols", symbols(args.nm, args.base),
+               symbols(args.nm, args.new), args.all)
+    except (OSError, subprocess.CalledProcessError) as err:
+        sys.exit("sizediff: %s" % err)
+
+
+if __name__ == "__main__":
+    main()